@@ -3,13 +3,21 @@
 
 #include <errno.h>
 #include <stddef.h>
+#include "failure_rules.h"
 
-typedef enum {
-    ERRNO_EFAULT = EFAULT,
-    ERRNO_EINVAL = EINVAL,
-    ERRNO_ENOMEM = ENOMEM,
-    ERRNO_EPIPE = EPIPE
-} SupportedErrno;
+typedef struct {
+    int err_val;
+    const char *name;
+    const char *description;
+    FailureType failure_type;       /* Default classification when no specific rule applies */
+} ErrnoInfo;
+
+/**
+ * Looks up an errno value in the build-time generated errno table.
+ * @param err_val The errno value to look up
+ * @return Pointer to ErrnoInfo struct, NULL if the value is not defined on this system
+ */
+const ErrnoInfo *analyze_errno(int err_val);
 
 /**
  * Maps an errno value to a failure category string.
@@ -2,30 +2,48 @@
 #define FAILURE_RULES_H
 
 #include <stddef.h>
+#include "pattern_dict.h"
+#include "kernel_log.h"
 
 typedef enum {
     FAILURE_MEMORY_CORRUPTION,
     FAILURE_INVALID_STATE,
     FAILURE_RESOURCE_EXHAUSTION,
-    FAILURE_TIMING_RACE
+    FAILURE_TIMING_RACE,
+    FAILURE_EXTERNAL_TERMINATION
 } FailureType;
 
+/* si_code details from signal_analyzer.h; that header includes this one */
+struct SiCodeInfo;
+
 typedef struct {
     FailureType failure_type;
+    int rule_id;                /* Number of the rule that matched, 0 if none did */
     const char *root_cause;
     const char *debug_steps;
 } FailureReport;
 
 /**
- * Evaluates failure based on signal, errno, and log data.
+ * Evaluates failure based on signal, errno, log data and kernel log events.
  * Populates the FailureReport structure.
  * @param signal_num Signal number (if available, -1 otherwise)
+ * @param si_code si_code the signal was delivered with (if it adds information, NULL otherwise)
  * @param err_val Errno value (if available, 0 otherwise)
  * @param log_file Path to log file (if available, NULL otherwise)
+ * @param dict Compiled pattern dictionary used to score the log file
+ * @param kernel Kernel log events for the program (if available, NULL otherwise)
  * @param report Output parameter to be populated with failure analysis
  * @return 0 on success, non-zero on error
  */
-int evaluate_failure(int signal_num, int err_val, const char *log_file, FailureReport *report);
+int evaluate_failure(int signal_num, const struct SiCodeInfo *si_code, int err_val, const char *log_file,
+                     const PatternDict *dict, const KernelEvents *kernel, FailureReport *report);
+
+/**
+ * Returns a human-readable name for a failure type.
+ * @param type The failure type
+ * @return Pointer to a static string ("Unknown" for out-of-range values)
+ */
+const char *failure_type_name(FailureType type);
 
 #endif /* FAILURE_RULES_H */
 
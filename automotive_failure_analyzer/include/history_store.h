@@ -0,0 +1,184 @@
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/*
+ * Append-only columnar history of analysis results.
+ *
+ * A store is a directory holding one fixed-width file per column
+ * (<column>.col), a target name dictionary (targets.dict, one name per line,
+ * line index = target id) and a lock file. Appends are serialized with
+ * flock() and write one value to the end of every column file; a row is
+ * visible once all columns contain it. Queries mmap only the column files
+ * they read, on first use.
+ */
+
+typedef enum {
+    HISTORY_COL_TIMESTAMP,          /* int64, seconds since the epoch */
+    HISTORY_COL_TARGET,             /* uint32, id into targets.dict */
+    HISTORY_COL_SIGNAL,             /* int8, -1 if none */
+    HISTORY_COL_ERRNO,              /* int16, 0 if none */
+    HISTORY_COL_EXIT_CODE,          /* int16, -1 if none */
+    HISTORY_COL_FAILURE_TYPE,       /* uint8, HISTORY_NO_FAILURE if none */
+    HISTORY_COL_RULE_ID,            /* uint8, 0 if no rule matched */
+    HISTORY_COL_SIGNATURE,          /* uint64, hash of the fields above except timestamp */
+    HISTORY_COLUMN_COUNT
+} HistoryColumn;
+
+/* Pseudo-column for group-by: timestamp truncated to whole days (UTC) */
+#define HISTORY_GROUP_DAY HISTORY_COLUMN_COUNT
+#define HISTORY_GROUP_NONE (-1)
+
+#define HISTORY_NO_FAILURE 255
+#define HISTORY_MAX_FILTERS 16
+
+typedef struct {
+    int64_t timestamp;
+    const char *target;
+    int signal_num;
+    int err_val;
+    int exit_code;
+    int failure_type;               /* FailureType, or HISTORY_NO_FAILURE */
+    int rule_id;
+} HistoryRecord;
+
+typedef struct {
+    int lock_fd;
+    int column_fds[HISTORY_COLUMN_COUNT];
+    int dict_fd;
+    char **targets;                 /* Cached copy of targets.dict */
+    size_t target_count;
+    size_t target_capacity;
+    off_t dict_size;                /* Bytes of targets.dict already cached */
+} HistoryWriter;
+
+typedef struct {
+    int column_fds[HISTORY_COLUMN_COUNT];   /* Open until the column is mapped */
+    const void *columns[HISTORY_COLUMN_COUNT]; /* NULL until a query reads the column */
+    size_t mapped_sizes[HISTORY_COLUMN_COUNT];
+    size_t row_count;
+    char **targets;
+    size_t target_count;
+} HistoryStore;
+
+typedef struct {
+    HistoryColumn column;
+    int64_t value;
+} HistoryFilter;
+
+typedef struct {
+    int64_t since;                  /* Inclusive, INT64_MIN for no bound */
+    int64_t until;                  /* Inclusive, INT64_MAX for no bound */
+    HistoryFilter filters[HISTORY_MAX_FILTERS];
+    size_t filter_count;
+    int group_by;                   /* HistoryColumn, HISTORY_GROUP_DAY or HISTORY_GROUP_NONE */
+} HistoryQuery;
+
+typedef struct {
+    int64_t key;
+    uint64_t count;
+} HistoryGroup;
+
+typedef struct {
+    uint64_t rows_scanned;
+    uint64_t rows_matched;
+    HistoryGroup *groups;           /* Sorted by key; NULL when not grouping */
+    size_t group_count;
+} HistoryQueryResult;
+
+/**
+ * Opens (creating if needed) a history store directory for appending.
+ * @param dir Store directory (its parent must exist)
+ * @param writer Output parameter for the open writer
+ * @return 0 on success, non-zero on error
+ */
+int history_writer_open(const char *dir, HistoryWriter *writer);
+
+/**
+ * Appends one record. Safe against concurrent writers in other processes.
+ * @param writer Open writer
+ * @param record Record to append (timestamp 0 means "now"); a timestamp older
+ *               than the last stored one is raised to it, so the timestamp
+ *               column stays sorted for range queries
+ * @return 0 on success, non-zero on error
+ */
+int history_writer_append(HistoryWriter *writer, const HistoryRecord *record);
+
+/**
+ * Closes a writer and releases its resources.
+ * @param writer Writer to close (may be NULL)
+ */
+void history_writer_close(HistoryWriter *writer);
+
+/**
+ * Computes the signature hash stored for a record (FNV-1a over the target
+ * name and the classification fields).
+ * @param record Record to hash
+ * @return 64-bit signature
+ */
+uint64_t history_signature(const HistoryRecord *record);
+
+/**
+ * Opens a history store read-only for querying. The row count is fixed here;
+ * column files are mapped by the first query that reads them.
+ * @param dir Store directory
+ * @param store Output parameter for the mapped store
+ * @return 0 on success, non-zero on error
+ */
+int history_store_open(const char *dir, HistoryStore *store);
+
+/**
+ * Unmaps a history store and closes its files.
+ * @param store Store to close (may be NULL)
+ */
+void history_store_close(HistoryStore *store);
+
+/**
+ * Runs a filter / group-by scan, mapping the columns it reads.
+ * @param store Open store
+ * @param query Query to run
+ * @param result Output parameter; free with history_query_result_free()
+ * @return 0 on success, non-zero on error
+ */
+int history_query(HistoryStore *store, const HistoryQuery *query, HistoryQueryResult *result);
+
+/**
+ * Releases memory owned by a query result.
+ * @param result Result to free (may be NULL)
+ */
+void history_query_result_free(HistoryQueryResult *result);
+
+/**
+ * Parses a column name as used by the query subcommand.
+ * @param name Column name (timestamp, target, signal, errno, exit, type, rule, signature, day)
+ * @return HistoryColumn / HISTORY_GROUP_DAY, or -1 if unknown
+ */
+int history_column_from_name(const char *name);
+
+/**
+ * Returns the query-subcommand name of a column.
+ * @param column HistoryColumn or HISTORY_GROUP_DAY
+ * @return Pointer to a static string
+ */
+const char *history_column_name(int column);
+
+/**
+ * Looks up a target id by name.
+ * @param store Open store
+ * @param name Target name
+ * @return Target id, or -1 if the store has no such target
+ */
+int64_t history_target_id(const HistoryStore *store, const char *name);
+
+/**
+ * Looks up a target name by id.
+ * @param store Open store
+ * @param id Target id
+ * @return Target name, or NULL if out of range
+ */
+const char *history_target_name(const HistoryStore *store, int64_t id);
+
+#endif /* HISTORY_STORE_H */
@@ -0,0 +1,88 @@
+#ifndef KERNEL_LOG_H
+#define KERNEL_LOG_H
+
+#include <stddef.h>
+
+/*
+ * Correlation of a supervised program with the kernel log (/dev/kmsg).
+ *
+ * A cursor is opened before the program is launched and positioned after the
+ * newest record, so collecting afterwards reads only the records the kernel
+ * produced while the program ran; older history is never read.
+ */
+
+/* x86 page fault error code bits ("segfault at ... error N") */
+#define KERNEL_FAULT_PROTECTION 0x1     /* Page was present (protection violation) */
+#define KERNEL_FAULT_WRITE 0x2          /* Access was a write */
+#define KERNEL_FAULT_USER 0x4           /* Fault in user mode */
+#define KERNEL_FAULT_INSTRUCTION 0x10   /* Fault on instruction fetch */
+
+typedef struct {
+    int fd;                         /* /dev/kmsg opened non-blocking, -1 if unavailable */
+} KernelLogCursor;
+
+typedef struct {
+    size_t records_read;            /* New records read since the cursor was opened */
+    size_t records_lost;            /* Records overwritten before they could be read (at least) */
+
+    /* Fault reported for the program: "segfault", "divide error", "general protection fault", ... */
+    int has_fault;
+    char fault_kind[48];
+    int has_fault_address;          /* Only page faults report the faulting address */
+    unsigned long fault_address;
+    unsigned long fault_ip;
+    unsigned long fault_error;      /* Page fault / trap error code (ESR on arm64) */
+
+    /* OOM killer selected the program */
+    int oom_killed;
+    int oom_memcg;                  /* Kill was caused by a memory cgroup limit */
+    unsigned long oom_total_vm_kb;
+    unsigned long oom_anon_rss_kb;
+    unsigned long oom_file_rss_kb;
+    unsigned long oom_shmem_rss_kb;
+    int oom_score_adj;
+
+    /* Hung task detector reported the program */
+    int hung_task;
+    unsigned long hung_seconds;
+} KernelEvents;
+
+/**
+ * Opens a cursor positioned after the newest kernel log record, without reading
+ * the existing records.
+ * @param cursor Output parameter for the cursor; its fd is -1 if the kernel
+ *               log is unavailable (no /dev/kmsg or no permission)
+ * @return 0 on success, non-zero if the kernel log could not be opened
+ */
+int kernel_log_open(KernelLogCursor *cursor);
+
+/**
+ * Reads all records added since the cursor was opened, without blocking, and
+ * extracts fault, OOM and hung-task reports for one process. A record matches
+ * when both its PID and its command name (the program's base name, truncated
+ * as the kernel does) match.
+ * @param cursor Open cursor; advanced past the records read
+ * @param pid Process ID of the program
+ * @param program Path the program was executed as
+ * @param events Output parameter for the extracted events
+ * @return 0 on success, non-zero on error (including an unavailable cursor)
+ */
+int kernel_log_collect(KernelLogCursor *cursor, int pid, const char *program, KernelEvents *events);
+
+/**
+ * Closes a cursor.
+ * @param cursor Cursor to close (may be NULL)
+ */
+void kernel_log_close(KernelLogCursor *cursor);
+
+/**
+ * Describes the fault in a set of kernel events, decoding the x86 page fault
+ * error code, e.g. "segfault at 0x0 (ip 0x401136, error 6: user-mode write,
+ * page not present)".
+ * @param events Events with has_fault set
+ * @param buffer Output buffer
+ * @param size Size of the output buffer
+ */
+void kernel_fault_describe(const KernelEvents *events, char *buffer, size_t size);
+
+#endif /* KERNEL_LOG_H */
@@ -2,21 +2,19 @@
 #define LOG_PARSER_H
 
 #include <stddef.h>
+#include "pattern_dict.h"
 
 typedef struct {
-    int has_segfault_keywords;      /* Found "segfault", "segmentation", "SIGSEGV" */
-    int has_memory_keywords;         /* Found "memory", "malloc", "free", "leak" */
-    int has_timeout_keywords;        /* Found "timeout", "deadlock", "hung" */
-    int has_resource_keywords;       /* Found "out of memory", "ENOMEM", "resource" */
+    double category_scores[PATTERN_CATEGORY_COUNT];  /* Summed weights of matched patterns, indexed by PatternCategory */
 } LogAnalysis;
 
 /**
- * Parses a log file line-by-line and scans for failure-related keywords.
+ * Scans a log file with a compiled pattern dictionary and scores each failure category.
  * @param filename Path to the log file to parse (NULL is valid, returns empty analysis)
- * @param analysis Output parameter to be populated with keyword flags
+ * @param dict Compiled pattern dictionary (required when filename is non-NULL)
+ * @param analysis Output parameter to be populated with per-category scores
  * @return 0 on success, non-zero on error
  */
-int parse_log_file(const char *filename, LogAnalysis *analysis);
+int parse_log_file(const char *filename, const PatternDict *dict, LogAnalysis *analysis);
 
 #endif /* LOG_PARSER_H */
-
@@ -0,0 +1,39 @@
+#ifndef MANIFEST_RUNNER_H
+#define MANIFEST_RUNNER_H
+
+/*
+ * Manifest-driven regression runner.
+ *
+ * A manifest lists one test per line:
+ *
+ *     <expected> [name=<name>] [timeout=<seconds>] [trace-errno[=<syscalls>]] <command> [args...]
+ *
+ * where <expected> is SUCCESS, FAILURE (non-zero exit, unclassified),
+ * EXEC_FAILURE, UNKNOWN, TIMEOUT or a failure type (MEMORY_CORRUPTION,
+ * INVALID_STATE, RESOURCE_EXHAUSTION, TIMING_RACE, EXTERNAL_TERMINATION).
+ * Blank lines and lines starting with '#' are ignored; arguments may be
+ * double-quoted. Relative command paths containing a '/' are resolved against
+ * the manifest's directory.
+ *
+ * Every test runs in its own worker process and process group, so a timeout
+ * kills the whole process tree of that test and nothing else.
+ */
+
+#define MANIFEST_DEFAULT_TIMEOUT 30.0          /* Seconds per test */
+#define MANIFEST_WORKERS_PER_CPU 2             /* Default pool size per online CPU */
+
+typedef struct {
+    const char *junit_file;         /* JUnit XML report path, NULL for none */
+    int workers;                    /* Maximum concurrent tests, 0 for the default */
+    double timeout;                 /* Default per-test timeout in seconds, 0 for the default */
+} ManifestOptions;
+
+/**
+ * Runs every test in a manifest on a bounded worker pool and reports the results.
+ * @param manifest_file Path to the manifest
+ * @param options Runner options
+ * @return EXIT_SUCCESS if every test matched its expectation, EXIT_FAILURE otherwise
+ */
+int run_manifest(const char *manifest_file, const ManifestOptions *options);
+
+#endif /* MANIFEST_RUNNER_H */
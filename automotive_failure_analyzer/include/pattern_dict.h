@@ -0,0 +1,107 @@
+#ifndef PATTERN_DICT_H
+#define PATTERN_DICT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    PATTERN_CATEGORY_SEGFAULT,      /* "segfault", "segmentation", "SIGSEGV" */
+    PATTERN_CATEGORY_MEMORY,        /* "memory", "malloc", "free", "leak" */
+    PATTERN_CATEGORY_TIMEOUT,       /* "timeout", "deadlock", "hung" */
+    PATTERN_CATEGORY_RESOURCE,      /* "out of memory", "ENOMEM", "resource" */
+    PATTERN_CATEGORY_COUNT
+} PatternCategory;
+
+typedef struct {
+    char *text;                     /* Lowercased pattern */
+    size_t length;
+    PatternCategory category;
+    double weight;
+} PatternEntry;
+
+typedef struct {
+    /* Patterns collected before compilation */
+    PatternEntry *entries;
+    size_t entry_count;
+    size_t entry_capacity;
+
+    /* Compiled Aho-Corasick automaton (complete DFA over byte classes) */
+    int compiled;
+    uint8_t class_map[256];         /* Byte -> class; class 0 never appears in a pattern */
+    size_t class_count;
+    int32_t *transitions;           /* state_count * class_count table of (next_state << 1 | has_output) */
+    double *scores;                 /* state_count * PATTERN_CATEGORY_COUNT weight sums */
+    uint8_t *has_output;            /* Non-zero if any pattern ends in this state */
+    size_t state_count;
+} PatternDict;
+
+/**
+ * Initializes an empty pattern dictionary.
+ * @param dict Dictionary to initialize
+ */
+void pattern_dict_init(PatternDict *dict);
+
+/**
+ * Releases all memory owned by a pattern dictionary.
+ * @param dict Dictionary to free (may be NULL)
+ */
+void pattern_dict_free(PatternDict *dict);
+
+/**
+ * Adds a single case-insensitive pattern. Must be called before compilation.
+ * @param dict Dictionary to add to
+ * @param pattern Non-empty pattern text (no newlines)
+ * @param category Failure category the pattern contributes to
+ * @param weight Score added to the category on every match; must be finite and > 0
+ * @return 0 on success, non-zero on error
+ */
+int pattern_dict_add(PatternDict *dict, const char *pattern, PatternCategory category, double weight);
+
+/**
+ * Adds the built-in keyword set (weight 1.0 each).
+ * @param dict Dictionary to add to
+ * @return 0 on success, non-zero on error
+ */
+int pattern_dict_add_defaults(PatternDict *dict);
+
+/**
+ * Loads patterns from a dictionary file. Each non-empty line that does not
+ * start with '#' has the form "<category> <weight> <pattern text>", where
+ * category is one of segfault, memory, timeout, resource and the pattern
+ * text runs to the end of the line. Lines may be of any length.
+ * @param dict Dictionary to add to
+ * @param filename Path to the dictionary file
+ * @return 0 on success, non-zero on error (unreadable file or malformed line)
+ */
+int pattern_dict_load_file(PatternDict *dict, const char *filename);
+
+/**
+ * Compiles all added patterns into a single matching automaton.
+ * @param dict Dictionary to compile
+ * @return 0 on success, non-zero on error
+ */
+int pattern_dict_compile(PatternDict *dict);
+
+/**
+ * Scans a chunk of text with a compiled dictionary, adding the weight of every
+ * match to scores. Matching is case-insensitive and never spans a newline. A
+ * match that ends a longer match of another category is not scored, so
+ * "out of memory" counts for resource only, not for memory as well.
+ * Scan cost is one table lookup per byte regardless of dictionary size.
+ * @param dict Compiled dictionary
+ * @param text Text to scan
+ * @param length Number of bytes in text
+ * @param state In/out automaton state, start at 0 and carry across chunks
+ * @param scores Array of PATTERN_CATEGORY_COUNT sums to accumulate into
+ */
+void pattern_dict_scan(const PatternDict *dict, const char *text, size_t length, int32_t *state, double *scores);
+
+/**
+ * Parses a category name as used in dictionary files.
+ * @param name Category name (case-insensitive)
+ * @param category Output parameter for the parsed category
+ * @return 0 on success, non-zero if the name is unknown
+ */
+int pattern_category_from_name(const char *name, PatternCategory *category);
+
+#endif /* PATTERN_DICT_H */
@@ -2,16 +2,47 @@
 #define PROCESS_RUNNER_H
 
 #include <stddef.h>
+#include "kernel_log.h"
+
+#define SYSCALL_TRACE_MAX 64
 
 typedef struct {
     int ran_successfully;      /* Program launched successfully */
+    int pid;                   /* Process ID of the program, 0 if not launched */
     int exited_normally;       /* Program called exit() */
     int exit_code;             /* Valid only if exited_normally == 1 */
     int terminated_by_signal;  /* Program was killed by signal */
     int signal_number;         /* Valid only if terminated_by_signal == 1 */
     int core_dumped;           /* Core dump was generated */
+    int syscalls_traced;       /* Errno tracing was active for this run */
+    int failed_syscall;        /* Last traced syscall that failed, -1 if none */
+    int syscall_errno;         /* errno of failed_syscall, 0 if none */
+    unsigned long syscall_failures; /* Number of traced syscalls that failed */
+    int has_signal_info;       /* Traced runs: siginfo of the terminating signal was captured */
+    int signal_code;           /* si_code of the terminating signal, valid only if has_signal_info == 1 */
+    int signal_sender;         /* Sending PID for SI_USER/SI_QUEUE/SI_TKILL, 0 otherwise */
+    int has_fault_address;     /* Kernel-generated SIGSEGV/SIGBUS/SIGILL/SIGFPE carried a fault address */
+    unsigned long fault_address; /* si_addr, valid only if has_fault_address == 1 */
 } ProcessResult;
 
+/* si_code details from signal_analyzer.h */
+struct SiCodeInfo;
+
+/* How a --run target ended, before any rule is applied */
+typedef enum {
+    RUN_OUTCOME_SUCCESS,            /* Exit status 0, even if traced syscalls failed */
+    RUN_OUTCOME_EXEC_FAILURE,       /* Exit status 127: the program could not be executed */
+    RUN_OUTCOME_SIGNALED,           /* Killed by a signal: classify with the rules */
+    RUN_OUTCOME_EXIT_CLASSIFIED,    /* Non-zero exit with a traced errno or kernel report to classify */
+    RUN_OUTCOME_EXIT_FAILURE,       /* Non-zero exit status with nothing to classify */
+    RUN_OUTCOME_UNKNOWN_STATE       /* Neither exited nor signaled */
+} RunOutcome;
+
+typedef struct {
+    int syscalls[SYSCALL_TRACE_MAX];    /* Syscall numbers that stop in the tracer */
+    size_t syscall_count;
+} SyscallTraceConfig;
+
 /**
  * Runs a target program and monitors its termination.
  * Uses fork(), execvp(), and waitpid() to observe process behavior.
@@ -22,5 +53,55 @@ typedef struct {
  */
 int run_and_monitor(char *program, char **args, ProcessResult *result);
 
-#endif /* PROCESS_RUNNER_H */
+/**
+ * Runs a target program under a seccomp-assisted tracer that records the errno
+ * of failing system calls. The child installs a seccomp filter that hands only
+ * the configured syscalls to the tracer; all other syscalls run untouched.
+ * Descendants of the program are traced too. The call returns once the program
+ * has exited; descendants still running are killed when the caller exits
+ * (PTRACE_O_EXITKILL). The siginfo of the signal that terminates the program
+ * is captured as well.
+ * @param program Path to the program to execute
+ * @param args Array of arguments (program name + args, terminated by NULL)
+ * @param config Syscalls to trace, or NULL to run untraced
+ * @param result Output parameter to be populated with termination metadata
+ * @return 0 on success, non-zero on error (fork/exec/ptrace failure, or
+ *         tracing unsupported on this architecture)
+ */
+int run_and_monitor_traced(char *program, char **args, const SyscallTraceConfig *config, ProcessResult *result);
+
+/**
+ * Returns the si_code of the terminating signal when it tells the failure rules
+ * more than the signal number: a fault code such as SEGV_ACCERR, SI_KERNEL, or
+ * a signal sent by another process. Signals the program raised itself (abort(),
+ * raise()) and codes from its own timers or I/O add nothing and give NULL.
+ * @param result Termination metadata from run_and_monitor_traced()
+ * @return Pointer to the si_code entry, NULL if there is none worth using
+ */
+const struct SiCodeInfo *run_signal_code(const ProcessResult *result);
+
+/**
+ * Decides how a --run target ended and whether the rules can classify it.
+ * @param result Termination metadata from run_and_monitor_traced()
+ * @param kernel Kernel log events for the program (if available, NULL otherwise)
+ * @return Run outcome
+ */
+RunOutcome evaluate_run_outcome(const ProcessResult *result, const KernelEvents *kernel);
+
+/**
+ * Builds a trace configuration from a comma-separated list of syscall names.
+ * @param list Syscall names (e.g. "mmap,brk,write"), or NULL for the default
+ *             set (mmap, mremap, brk, mprotect, write, writev)
+ * @param config Output parameter for the configuration
+ * @return 0 on success, non-zero if a name is unknown or the list is too long
+ */
+int syscall_trace_config_parse(const char *list, SyscallTraceConfig *config);
+
+/**
+ * Returns the name of a system call on the build architecture.
+ * @param nr Syscall number
+ * @return Pointer to a static string, NULL if the number is unknown
+ */
+const char *syscall_name(int nr);
 
+#endif /* PROCESS_RUNNER_H */
@@ -0,0 +1,13 @@
+#ifndef QUERY_COMMAND_H
+#define QUERY_COMMAND_H
+
+/**
+ * Runs the "query" subcommand: filter and group-by scans over a history store.
+ * @param argc Argument count, argv[0] is "query"
+ * @param argv Subcommand arguments
+ * @param history_dir Default store directory (may be NULL, overridden by -H)
+ * @return Process exit status (EXIT_SUCCESS or EXIT_FAILURE)
+ */
+int run_query_command(int argc, char *argv[], const char *history_dir);
+
+#endif /* QUERY_COMMAND_H */
@@ -3,26 +3,38 @@
 
 #include <signal.h>
 #include <stddef.h>
-
-typedef enum {
-    SUPPORTED_SIGSEGV = SIGSEGV,
-    SUPPORTED_SIGABRT = SIGABRT,
-    SUPPORTED_SIGBUS = SIGBUS,
-    SUPPORTED_SIGFPE = SIGFPE
-} SupportedSignal;
+#include "failure_rules.h"
 
 typedef struct {
     int signal_num;
     const char *name;
     const char *description;
+    FailureType failure_type;       /* Default classification when no specific rule applies */
 } SignalInfo;
 
+typedef struct SiCodeInfo {
+    int si_code;
+    const char *name;
+    const char *description;
+    FailureType failure_type;
+} SiCodeInfo;
+
 /**
  * Analyzes a signal number and returns information about it.
+ * Constant-time lookup in the build-time generated signal table.
  * @param signal_num The signal number to analyze
- * @return Pointer to SignalInfo struct containing signal details
+ * @return Pointer to SignalInfo struct containing signal details, NULL if unknown
  */
 const SignalInfo *analyze_signal(int signal_num);
 
+/**
+ * Looks up the si_code delivered with a signal (e.g. SEGV_MAPERR, SI_USER).
+ * Constant-time lookup in the build-time generated si_code tables.
+ * @param signal_num The signal the code was delivered with
+ * @param si_code The siginfo_t si_code value
+ * @return Pointer to SiCodeInfo struct, NULL if the code is unknown for this signal
+ */
+const SiCodeInfo *analyze_si_code(int signal_num, int si_code);
+
 #endif /* SIGNAL_ANALYZER_H */
 
@@ -0,0 +1,38 @@
+#ifndef SYS_TABLES_H
+#define SYS_TABLES_H
+
+#include <stddef.h>
+#include "signal_analyzer.h"
+#include "errno_mapper.h"
+
+/*
+ * Dense lookup tables generated at build time by tools/gen_tables.c from the
+ * system headers (see gen/sys_tables.c). Unused slots have a NULL name.
+ */
+
+typedef struct {
+    const SiCodeInfo *codes;        /* Index 0 is SI_KERNEL, 1..count-1 are the signal-specific codes */
+    size_t count;
+} SiCodeTable;
+
+/* Indexed by signal number, 0.._NSIG-1 */
+extern const SignalInfo sys_signal_table[];
+extern const size_t sys_signal_table_size;
+
+/* Indexed by errno value, 0..max errno */
+extern const ErrnoInfo sys_errno_table[];
+extern const size_t sys_errno_table_size;
+
+/* Indexed by signal number, same size as sys_signal_table */
+extern const SiCodeTable sys_si_code_tables[];
+
+/* Codes generated by user space (SI_USER, SI_QUEUE, ...), indexed by si_code - sys_si_code_generic_min */
+extern const SiCodeInfo sys_si_code_generic_table[];
+extern const int sys_si_code_generic_min;
+extern const size_t sys_si_code_generic_size;
+
+/* System call names for the build architecture, indexed by syscall number */
+extern const char *const sys_syscall_names[];
+extern const size_t sys_syscall_names_size;
+
+#endif /* SYS_TABLES_H */
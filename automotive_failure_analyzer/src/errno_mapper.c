@@ -1,17 +1,18 @@
 #include "errno_mapper.h"
+#include "sys_tables.h"
 
-const char *map_errno(int err_val) {
-    switch (err_val) {
-        case EFAULT:
-            return "Memory Corruption";
-        case EINVAL:
-            return "Invalid State";
-        case ENOMEM:
-            return "Resource Exhaustion";
-        case EPIPE:
-            return "Invalid State";
-        default:
-            return "Unknown Error";
+const ErrnoInfo *analyze_errno(int err_val) {
+    if (err_val <= 0 || (size_t)err_val >= sys_errno_table_size) {
+        return NULL;
     }
+    const ErrnoInfo *info = &sys_errno_table[err_val];
+    return info->name != NULL ? info : NULL;
 }
 
+const char *map_errno(int err_val) {
+    const ErrnoInfo *info = analyze_errno(err_val);
+    if (info == NULL) {
+        return "Unknown Error";
+    }
+    return failure_type_name(info->failure_type);
+}
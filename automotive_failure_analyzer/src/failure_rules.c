@@ -1,3 +1,4 @@
+#define _POSIX_C_SOURCE 200809L
 #include "failure_rules.h"
 #include "signal_analyzer.h"
 #include "errno_mapper.h"
@@ -9,35 +10,144 @@ static const char *ROOT_CAUSE_MEMORY_CORRUPTION = "Invalid memory access - null
 static const char *ROOT_CAUSE_INVALID_STATE = "Invalid operation or state violation";
 static const char *ROOT_CAUSE_RESOURCE_EXHAUSTION = "System resource limit exceeded";
 static const char *ROOT_CAUSE_TIMING_RACE = "Concurrency issue - race condition or deadlock";
+static const char *ROOT_CAUSE_EXTERNAL_TERMINATION = "Process terminated by a signal from outside the program";
+static const char *ROOT_CAUSE_NULL_DEREFERENCE = "Null pointer dereference - kernel reported a fault near address 0";
+static const char *ROOT_CAUSE_BAD_JUMP = "Jump to non-executable memory - corrupted function pointer or return address";
+static const char *ROOT_CAUSE_READ_ONLY_WRITE = "Write to read-only memory - string literal or const data modified";
+static const char *ROOT_CAUSE_PROTECTION_FAULT = "General protection fault - non-canonical address, typically a corrupted pointer";
+static const char *ROOT_CAUSE_DIVIDE_ERROR = "Integer division by zero (kernel trap: divide error)";
+static const char *ROOT_CAUSE_OOM_KILL = "Killed by the kernel OOM killer - system out of memory";
+static const char *ROOT_CAUSE_OOM_KILL_MEMCG = "Killed by the kernel OOM killer - memory cgroup limit exceeded";
+static const char *ROOT_CAUSE_SENT_SIGNAL = "Signal sent by another process with kill() or sigqueue() - not raised by a fault in the program";
+static const char *ROOT_CAUSE_HUNG_TASK = "Task blocked in uninterruptible sleep (kernel hung task warning) - I/O stall or kernel lock deadlock";
 
 static const char *DEBUG_STEPS_MEMORY = "1. Run with valgrind: valgrind --leak-check=full <program>\n2. Use AddressSanitizer: gcc -fsanitize=address <sources>\n3. Check stack traces with gdb: gdb <program> core\n4. Review pointer arithmetic and array bounds";
 static const char *DEBUG_STEPS_INVALID_STATE = "1. Review assertion failures and abort conditions\n2. Check function preconditions and state validation\n3. Enable core dumps: ulimit -c unlimited\n4. Use strace to trace system calls";
 static const char *DEBUG_STEPS_RESOURCE = "1. Check memory limits: ulimit -v\n2. Monitor resource usage: top, ps aux\n3. Review memory allocation patterns\n4. Check for memory leaks with valgrind --leak-check=full";
 static const char *DEBUG_STEPS_TIMING = "1. Review thread synchronization (mutexes, semaphores)\n2. Use thread sanitizer: gcc -fsanitize=thread <sources>\n3. Add logging around critical sections\n4. Check for deadlock patterns in code";
+static const char *DEBUG_STEPS_OOM = "1. Check the kill record: dmesg | grep -i 'killed process'\n2. Compare anon-rss with the memory limit: cat /sys/fs/cgroup/<group>/memory.max\n3. Measure peak memory: /usr/bin/time -v <program>\n4. Check for memory leaks with valgrind --leak-check=full";
+static const char *DEBUG_STEPS_EXTERNAL = "1. Check the kernel log for OOM killer activity: dmesg | grep -i oom\n2. Review supervisor and watchdog timeouts (systemd, init scripts)\n3. Find the sender with auditd: auditctl -a always,exit -F arch=b64 -S kill\n4. Check resource limits that deliver signals: ulimit -a";
 
-int evaluate_failure(int signal_num, int err_val, const char *log_file, FailureReport *report) {
+const char *failure_type_name(FailureType type) {
+    switch (type) {
+        case FAILURE_MEMORY_CORRUPTION:
+            return "Memory Corruption";
+        case FAILURE_INVALID_STATE:
+            return "Invalid State";
+        case FAILURE_RESOURCE_EXHAUSTION:
+            return "Resource Exhaustion";
+        case FAILURE_TIMING_RACE:
+            return "Timing/Race";
+        case FAILURE_EXTERNAL_TERMINATION:
+            return "External Termination";
+        default:
+            return "Unknown";
+    }
+}
+
+static const char *debug_steps_for(FailureType type) {
+    switch (type) {
+        case FAILURE_MEMORY_CORRUPTION:
+            return DEBUG_STEPS_MEMORY;
+        case FAILURE_INVALID_STATE:
+            return DEBUG_STEPS_INVALID_STATE;
+        case FAILURE_RESOURCE_EXHAUSTION:
+            return DEBUG_STEPS_RESOURCE;
+        case FAILURE_TIMING_RACE:
+            return DEBUG_STEPS_TIMING;
+        case FAILURE_EXTERNAL_TERMINATION:
+        default:
+            return DEBUG_STEPS_EXTERNAL;
+    }
+}
+
+/* Picks a more specific root cause for a memory fault from the kernel's fault report */
+static const char *kernel_fault_root_cause(const KernelEvents *kernel) {
+    if (kernel == NULL || !kernel->has_fault) {
+        return NULL;
+    }
+    if (strcmp(kernel->fault_kind, "general protection fault") == 0) {
+        return ROOT_CAUSE_PROTECTION_FAULT;
+    }
+    if (!kernel->has_fault_address) {
+        return NULL;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    if (kernel->fault_error & KERNEL_FAULT_INSTRUCTION) {
+        return ROOT_CAUSE_BAD_JUMP;
+    }
+#endif
+    if (kernel->fault_address < 4096) {
+        return ROOT_CAUSE_NULL_DEREFERENCE;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    if ((kernel->fault_error & KERNEL_FAULT_PROTECTION) && (kernel->fault_error & KERNEL_FAULT_WRITE)) {
+        return ROOT_CAUSE_READ_ONLY_WRITE;
+    }
+#endif
+    return NULL;
+}
+
+/* Describes a fault more precisely than the signal does, e.g. SEGV_ACCERR or FPE_INTDIV */
+static const char *si_code_root_cause(int signal_num, const SiCodeInfo *si_code) {
+    if (si_code == NULL) {
+        return NULL;
+    }
+    if (si_code->si_code == SI_KERNEL) {
+#if defined(__x86_64__) || defined(__i386__)
+        /* x86 delivers general protection faults as SIGSEGV with SI_KERNEL */
+        return signal_num == SIGSEGV ? ROOT_CAUSE_PROTECTION_FAULT : NULL;
+#else
+        return NULL;
+#endif
+    }
+    return si_code->si_code > 0 ? si_code->description : NULL;
+}
+
+int evaluate_failure(int signal_num, const SiCodeInfo *si_code, int err_val, const char *log_file,
+                     const PatternDict *dict, const KernelEvents *kernel, FailureReport *report) {
     if (report == NULL) {
         return -1;
     }
 
     /* Initialize with defaults */
     report->failure_type = FAILURE_MEMORY_CORRUPTION;
+    report->rule_id = 0;
     report->root_cause = "Insufficient information to determine root cause";
     report->debug_steps = "Provide signal number (-s) or errno value (-e) for analysis";
 
     /* Parse log file first to get context */
-    LogAnalysis log_analysis = {0, 0, 0, 0};
+    LogAnalysis log_analysis = {{0}};
     if (log_file != NULL) {
-        if (parse_log_file(log_file, &log_analysis) != 0) {
+        if (parse_log_file(log_file, dict, &log_analysis) != 0) {
             /* Log file parsing failed, continue with signal/errno analysis */
         }
     }
 
     /* Deterministic rule-based evaluation: combine signal + errno + log context */
 
+    /* Rule 12: Kernel log shows the OOM killer chose this process -> Resource Exhaustion */
+    if (kernel != NULL && kernel->oom_killed) {
+        report->failure_type = FAILURE_RESOURCE_EXHAUSTION;
+        report->rule_id = 12;
+        report->root_cause = kernel->oom_memcg ? ROOT_CAUSE_OOM_KILL_MEMCG : ROOT_CAUSE_OOM_KILL;
+        report->debug_steps = DEBUG_STEPS_OOM;
+        return 0;
+    }
+
+    /* Rule 14: Signal sent by another process (SI_USER, SI_QUEUE, SI_TKILL) -> External Termination */
+    if (signal_num != -1 && si_code != NULL && si_code->si_code <= 0) {
+        report->failure_type = FAILURE_EXTERNAL_TERMINATION;
+        report->rule_id = 14;
+        report->root_cause = ROOT_CAUSE_SENT_SIGNAL;
+        report->debug_steps = DEBUG_STEPS_EXTERNAL;
+        return 0;
+    }
+
     /* Rule 1: SIGSEGV (11) or SIGBUS (7) -> Memory Corruption */
     if (signal_num == SIGSEGV || signal_num == SIGBUS) {
         report->failure_type = FAILURE_MEMORY_CORRUPTION;
+        report->rule_id = 1;
         const SignalInfo *sig_info = analyze_signal(signal_num);
         if (sig_info != NULL) {
             report->root_cause = sig_info->description;
@@ -46,22 +156,40 @@ int evaluate_failure(int signal_num, int err_val, const char *log_file, FailureR
         }
         report->debug_steps = DEBUG_STEPS_MEMORY;
 
-        /* Refine with errno if available */
+        /* Refine with the fault's si_code, then errno, if available */
+        const char *code_cause = si_code_root_cause(signal_num, si_code);
+        if (code_cause != NULL) {
+            report->root_cause = code_cause;
+        }
         if (err_val == EFAULT) {
             report->root_cause = "Invalid memory access - bad address (EFAULT)";
         }
+
+        /* Refine with the kernel's fault report if available */
+        const char *fault_cause = kernel_fault_root_cause(kernel);
+        if (fault_cause != NULL) {
+            report->root_cause = fault_cause;
+        }
         return 0;
     }
 
     /* Rule 2: SIGFPE (8) -> Invalid State */
     if (signal_num == SIGFPE) {
         report->failure_type = FAILURE_INVALID_STATE;
+        report->rule_id = 2;
         const SignalInfo *sig_info = analyze_signal(signal_num);
         if (sig_info != NULL) {
             report->root_cause = sig_info->description;
         } else {
             report->root_cause = ROOT_CAUSE_INVALID_STATE;
         }
+        const char *code_cause = si_code_root_cause(signal_num, si_code);
+        if (code_cause != NULL) {
+            report->root_cause = code_cause;
+        }
+        if (kernel != NULL && kernel->has_fault && strcmp(kernel->fault_kind, "divide error") == 0) {
+            report->root_cause = ROOT_CAUSE_DIVIDE_ERROR;
+        }
         report->debug_steps = DEBUG_STEPS_INVALID_STATE;
         return 0;
     }
@@ -69,6 +197,7 @@ int evaluate_failure(int signal_num, int err_val, const char *log_file, FailureR
     /* Rule 3: SIGABRT (6) -> Invalid State (typically assertion failure) */
     if (signal_num == SIGABRT) {
         report->failure_type = FAILURE_INVALID_STATE;
+        report->rule_id = 3;
         const SignalInfo *sig_info = analyze_signal(signal_num);
         if (sig_info != NULL) {
             report->root_cause = sig_info->description;
@@ -82,6 +211,7 @@ int evaluate_failure(int signal_num, int err_val, const char *log_file, FailureR
     /* Rule 4: ENOMEM (12) -> Resource Exhaustion */
     if (err_val == ENOMEM) {
         report->failure_type = FAILURE_RESOURCE_EXHAUSTION;
+        report->rule_id = 4;
         report->root_cause = ROOT_CAUSE_RESOURCE_EXHAUSTION;
         report->debug_steps = DEBUG_STEPS_RESOURCE;
         return 0;
@@ -90,6 +220,7 @@ int evaluate_failure(int signal_num, int err_val, const char *log_file, FailureR
     /* Rule 5: EFAULT (14) -> Memory Corruption */
     if (err_val == EFAULT) {
         report->failure_type = FAILURE_MEMORY_CORRUPTION;
+        report->rule_id = 5;
         report->root_cause = "Invalid memory address passed to system call (EFAULT)";
         report->debug_steps = DEBUG_STEPS_MEMORY;
         return 0;
@@ -98,6 +229,7 @@ int evaluate_failure(int signal_num, int err_val, const char *log_file, FailureR
     /* Rule 6: EINVAL (22) or EPIPE (32) -> Invalid State */
     if (err_val == EINVAL || err_val == EPIPE) {
         report->failure_type = FAILURE_INVALID_STATE;
+        report->rule_id = 6;
         if (err_val == EINVAL) {
             report->root_cause = "Invalid argument passed to system call (EINVAL)";
         } else {
@@ -107,30 +239,76 @@ int evaluate_failure(int signal_num, int err_val, const char *log_file, FailureR
         return 0;
     }
 
-    /* Rule 7: Log-based detection (timeout/deadlock keywords) */
-    if (log_analysis.has_timeout_keywords) {
+    /* Rule 13: Kernel hung task warning for this process -> Timing/Race */
+    if (kernel != NULL && kernel->hung_task) {
+        report->failure_type = FAILURE_TIMING_RACE;
+        report->rule_id = 13;
+        report->root_cause = ROOT_CAUSE_HUNG_TASK;
+        report->debug_steps = DEBUG_STEPS_TIMING;
+        return 0;
+    }
+
+    const double timeout_score = log_analysis.category_scores[PATTERN_CATEGORY_TIMEOUT];
+    const double resource_score = log_analysis.category_scores[PATTERN_CATEGORY_RESOURCE];
+    const double memory_score = log_analysis.category_scores[PATTERN_CATEGORY_MEMORY];
+    const int log_only = (err_val == 0 && signal_num == -1);
+
+    /* Rule 7: Log-based detection (timeout/deadlock keywords).
+     * With no signal/errno, only wins if it scores at least as high as the
+     * resource and memory categories. */
+    if (timeout_score > 0 &&
+        (!log_only || (timeout_score >= resource_score && timeout_score >= memory_score))) {
         report->failure_type = FAILURE_TIMING_RACE;
+        report->rule_id = 7;
         report->root_cause = ROOT_CAUSE_TIMING_RACE;
         report->debug_steps = DEBUG_STEPS_TIMING;
         return 0;
     }
 
-    /* Rule 8: Log-based detection (resource keywords) */
-    if (log_analysis.has_resource_keywords && err_val == 0 && signal_num == -1) {
+    /* Rule 8: Log-based detection (resource keywords), ties with memory go to resource */
+    if (log_only && resource_score > 0 && resource_score >= memory_score) {
         report->failure_type = FAILURE_RESOURCE_EXHAUSTION;
+        report->rule_id = 8;
         report->root_cause = ROOT_CAUSE_RESOURCE_EXHAUSTION;
         report->debug_steps = DEBUG_STEPS_RESOURCE;
         return 0;
     }
 
     /* Rule 9: Log-based detection (memory keywords) with no signal/errno */
-    if (log_analysis.has_memory_keywords && err_val == 0 && signal_num == -1) {
+    if (log_only && memory_score > 0) {
         report->failure_type = FAILURE_MEMORY_CORRUPTION;
+        report->rule_id = 9;
         report->root_cause = ROOT_CAUSE_MEMORY_CORRUPTION;
         report->debug_steps = DEBUG_STEPS_MEMORY;
         return 0;
     }
 
+    /* Rule 10: Any other known signal -> default mapping from the generated signal table */
+    if (signal_num != -1) {
+        const SignalInfo *sig_info = analyze_signal(signal_num);
+        if (sig_info != NULL) {
+            report->failure_type = sig_info->failure_type;
+            report->rule_id = 10;
+            report->root_cause = sig_info->failure_type == FAILURE_EXTERNAL_TERMINATION
+                                     ? ROOT_CAUSE_EXTERNAL_TERMINATION
+                                     : sig_info->description;
+            report->debug_steps = debug_steps_for(sig_info->failure_type);
+            return 0;
+        }
+    }
+
+    /* Rule 11: Any other known errno -> default mapping from the generated errno table */
+    if (err_val != 0) {
+        const ErrnoInfo *err_info = analyze_errno(err_val);
+        if (err_info != NULL) {
+            report->failure_type = err_info->failure_type;
+            report->rule_id = 11;
+            report->root_cause = err_info->description;
+            report->debug_steps = debug_steps_for(err_info->failure_type);
+            return 0;
+        }
+    }
+
     /* If we reach here, no clear match - return default */
     return 0;
 }
@@ -0,0 +1,834 @@
+#define _GNU_SOURCE
+#include "history_store.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SCAN_BLOCK_ROWS 4096
+#define SECONDS_PER_DAY 86400
+
+typedef enum {
+    STORAGE_INT8,
+    STORAGE_UINT8,
+    STORAGE_INT16,
+    STORAGE_UINT32,
+    STORAGE_INT64,
+    STORAGE_UINT64
+} StorageType;
+
+static const struct {
+    const char *name;
+    const char *file;
+    StorageType storage;
+    size_t width;
+} column_defs[HISTORY_COLUMN_COUNT] = {
+    {"timestamp", "timestamp.col", STORAGE_INT64, 8},
+    {"target", "target.col", STORAGE_UINT32, 4},
+    {"signal", "signal.col", STORAGE_INT8, 1},
+    {"errno", "errno.col", STORAGE_INT16, 2},
+    {"exit", "exit_code.col", STORAGE_INT16, 2},
+    {"type", "failure_type.col", STORAGE_UINT8, 1},
+    {"rule", "rule_id.col", STORAGE_UINT8, 1},
+    {"signature", "signature.col", STORAGE_UINT64, 8}
+};
+
+static const char *DICT_FILE = "targets.dict";
+static const char *LOCK_FILE = "history.lock";
+
+static int join_path(char *out, size_t size, const char *dir, const char *file) {
+    int written = snprintf(out, size, "%s/%s", dir, file);
+    return (written < 0 || (size_t)written >= size) ? -1 : 0;
+}
+
+static int write_all(int fd, const void *data, size_t length) {
+    const char *p = data;
+    while (length > 0) {
+        ssize_t written = write(fd, p, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
+
+static int add_target(char ***targets, size_t *count, size_t *capacity, const char *name, size_t length) {
+    if (*count == *capacity) {
+        size_t new_capacity = *capacity ? *capacity * 2 : 16;
+        char **grown = realloc(*targets, new_capacity * sizeof(*grown));
+        if (grown == NULL) {
+            return -1;
+        }
+        *targets = grown;
+        *capacity = new_capacity;
+    }
+    char *copy = malloc(length + 1);
+    if (copy == NULL) {
+        return -1;
+    }
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+    (*targets)[(*count)++] = copy;
+    return 0;
+}
+
+static void free_targets(char **targets, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(targets[i]);
+    }
+    free(targets);
+}
+
+/* Reads newline-terminated names from fd starting at offset; returns bytes consumed or -1 */
+static off_t read_targets(int fd, off_t offset, off_t end, char ***targets, size_t *count, size_t *capacity) {
+    if (end <= offset) {
+        return 0;
+    }
+    size_t length = (size_t)(end - offset);
+    char *buffer = malloc(length);
+    if (buffer == NULL) {
+        return -1;
+    }
+    ssize_t got = pread(fd, buffer, length, offset);
+    if (got < 0) {
+        free(buffer);
+        return -1;
+    }
+
+    size_t consumed = 0;
+    size_t start = 0;
+    for (size_t i = 0; i < (size_t)got; i++) {
+        if (buffer[i] == '\n') {
+            if (add_target(targets, count, capacity, buffer + start, i - start) != 0) {
+                free(buffer);
+                return -1;
+            }
+            start = i + 1;
+            consumed = start;
+        }
+    }
+    free(buffer);
+    return (off_t)consumed;
+}
+
+int history_writer_open(const char *dir, HistoryWriter *writer) {
+    if (dir == NULL || writer == NULL) {
+        return -1;
+    }
+    memset(writer, 0, sizeof(*writer));
+    writer->lock_fd = -1;
+    writer->dict_fd = -1;
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++) {
+        writer->column_fds[c] = -1;
+    }
+
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        return -1;
+    }
+
+    char path[PATH_MAX];
+    if (join_path(path, sizeof(path), dir, LOCK_FILE) != 0 ||
+        (writer->lock_fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644)) < 0) {
+        history_writer_close(writer);
+        return -1;
+    }
+    if (join_path(path, sizeof(path), dir, DICT_FILE) != 0 ||
+        (writer->dict_fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644)) < 0) {
+        history_writer_close(writer);
+        return -1;
+    }
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++) {
+        if (join_path(path, sizeof(path), dir, column_defs[c].file) != 0 ||
+            (writer->column_fds[c] = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644)) < 0) {
+            history_writer_close(writer);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void history_writer_close(HistoryWriter *writer) {
+    if (writer == NULL) {
+        return;
+    }
+    if (writer->lock_fd >= 0) {
+        close(writer->lock_fd);
+    }
+    if (writer->dict_fd >= 0) {
+        close(writer->dict_fd);
+    }
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++) {
+        if (writer->column_fds[c] >= 0) {
+            close(writer->column_fds[c]);
+        }
+    }
+    free_targets(writer->targets, writer->target_count);
+    memset(writer, 0, sizeof(*writer));
+    writer->lock_fd = -1;
+    writer->dict_fd = -1;
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++) {
+        writer->column_fds[c] = -1;
+    }
+}
+
+uint64_t history_signature(const HistoryRecord *record) {
+    uint64_t hash = 14695981039346656037ULL;
+    const char *target = record->target != NULL ? record->target : "";
+    for (const char *p = target; *p; p++) {
+        hash = (hash ^ (unsigned char)*p) * 1099511628211ULL;
+    }
+    int32_t fields[] = {
+        record->signal_num, record->err_val, record->exit_code, record->failure_type, record->rule_id
+    };
+    const unsigned char *bytes = (const unsigned char *)fields;
+    for (size_t i = 0; i < sizeof(fields); i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* Called with the lock held: picks up names added by other writers, returns the id for name */
+static int64_t writer_target_id(HistoryWriter *writer, const char *name) {
+    struct stat st;
+    if (fstat(writer->dict_fd, &st) != 0) {
+        return -1;
+    }
+    if (st.st_size > writer->dict_size) {
+        off_t consumed = read_targets(writer->dict_fd, writer->dict_size, st.st_size, &writer->targets,
+                                      &writer->target_count, &writer->target_capacity);
+        if (consumed < 0) {
+            return -1;
+        }
+        writer->dict_size += consumed;
+    }
+    if (st.st_size > writer->dict_size) {
+        /* A crashed writer left a partial name; O_APPEND would glue the next one onto it */
+        if (ftruncate(writer->dict_fd, writer->dict_size) != 0) {
+            return -1;
+        }
+    }
+
+    for (size_t i = 0; i < writer->target_count; i++) {
+        if (strcmp(writer->targets[i], name) == 0) {
+            return (int64_t)i;
+        }
+    }
+
+    /* New target: one write() of "name\n" so readers never see a partial line */
+    size_t length = strlen(name);
+    char *line = malloc(length + 1);
+    if (line == NULL) {
+        return -1;
+    }
+    memcpy(line, name, length);
+    line[length] = '\n';
+    int failed = write_all(writer->dict_fd, line, length + 1);
+    free(line);
+    if (failed || add_target(&writer->targets, &writer->target_count, &writer->target_capacity, name, length) != 0) {
+        return -1;
+    }
+    writer->dict_size += (off_t)(length + 1);
+    return (int64_t)(writer->target_count - 1);
+}
+
+/* Called with the lock held: drops any partially appended row left by a crashed writer */
+static int writer_repair(HistoryWriter *writer, off_t *row_count) {
+    off_t sizes[HISTORY_COLUMN_COUNT];
+    off_t rows = -1;
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++) {
+        struct stat st;
+        if (fstat(writer->column_fds[c], &st) != 0) {
+            return -1;
+        }
+        sizes[c] = st.st_size;
+        off_t column_rows = st.st_size / (off_t)column_defs[c].width;
+        if (rows < 0 || column_rows < rows) {
+            rows = column_rows;
+        }
+    }
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++) {
+        off_t expected = rows * (off_t)column_defs[c].width;
+        if (sizes[c] != expected && ftruncate(writer->column_fds[c], expected) != 0) {
+            return -1;
+        }
+    }
+    *row_count = rows;
+    return 0;
+}
+
+/* Called with the lock held: timestamp of the newest row, INT64_MIN if the store is empty */
+static int writer_last_timestamp(HistoryWriter *writer, off_t rows, int64_t *timestamp) {
+    *timestamp = INT64_MIN;
+    if (rows == 0) {
+        return 0;
+    }
+    ssize_t got = pread(writer->column_fds[HISTORY_COL_TIMESTAMP], timestamp, sizeof(*timestamp),
+                        (rows - 1) * (off_t)sizeof(*timestamp));
+    return got == (ssize_t)sizeof(*timestamp) ? 0 : -1;
+}
+
+int history_writer_append(HistoryWriter *writer, const HistoryRecord *record) {
+    if (writer == NULL || record == NULL || writer->lock_fd < 0) {
+        return -1;
+    }
+
+    /* Target names are line-delimited, so newlines are not allowed in them */
+    char target[PATH_MAX];
+    snprintf(target, sizeof(target), "%s", record->target != NULL ? record->target : "-");
+    for (char *p = target; *p; p++) {
+        if (*p == '\n' || *p == '\r') {
+            *p = ' ';
+        }
+    }
+
+    HistoryRecord normalized = *record;
+    normalized.target = target;
+
+    if (flock(writer->lock_fd, LOCK_EX) != 0) {
+        return -1;
+    }
+
+    int result = -1;
+    off_t rows;
+    int64_t last_timestamp;
+    int64_t target_id = writer_target_id(writer, target);
+    if (target_id >= 0 && target_id <= UINT32_MAX && writer_repair(writer, &rows) == 0 &&
+        writer_last_timestamp(writer, rows, &last_timestamp) == 0) {
+        /* Timestamp is taken and clamped under the lock so the column stays sorted for range
+         * queries, even across a backwards clock step or an older caller-supplied timestamp */
+        int64_t timestamp = record->timestamp != 0 ? record->timestamp : (int64_t)time(NULL);
+        if (timestamp < last_timestamp) {
+            timestamp = last_timestamp;
+        }
+        int8_t signal_value = (int8_t)record->signal_num;
+        int16_t errno_value = (int16_t)record->err_val;
+        int16_t exit_value = (int16_t)record->exit_code;
+        uint8_t type_value = (uint8_t)record->failure_type;
+        uint8_t rule_value = (uint8_t)record->rule_id;
+        uint32_t target_value = (uint32_t)target_id;
+        uint64_t signature = history_signature(&normalized);
+
+        const void *values[HISTORY_COLUMN_COUNT] = {
+            &timestamp, &target_value, &signal_value, &errno_value,
+            &exit_value, &type_value, &rule_value, &signature
+        };
+
+        result = 0;
+        for (int c = 0; c < HISTORY_COLUMN_COUNT && result == 0; c++) {
+            result = write_all(writer->column_fds[c], values[c], column_defs[c].width);
+        }
+    }
+
+    flock(writer->lock_fd, LOCK_UN);
+    return result;
+}
+
+int history_store_open(const char *dir, HistoryStore *store) {
+    if (dir == NULL || store == NULL) {
+        return -1;
+    }
+    memset(store, 0, sizeof(*store));
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++) {
+        store->column_fds[c] = -1;
+    }
+
+    char path[PATH_MAX];
+    size_t rows = SIZE_MAX;
+
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++) {
+        if (join_path(path, sizeof(path), dir, column_defs[c].file) != 0) {
+            history_store_close(store);
+            return -1;
+        }
+        store->column_fds[c] = open(path, O_RDONLY | O_CLOEXEC);
+        struct stat st;
+        if (store->column_fds[c] < 0 || fstat(store->column_fds[c], &st) != 0) {
+            history_store_close(store);
+            return -1;
+        }
+        size_t column_rows = (size_t)st.st_size / column_defs[c].width;
+        if (column_rows < rows) {
+            rows = column_rows;
+        }
+    }
+    store->row_count = rows;
+
+    if (join_path(path, sizeof(path), dir, DICT_FILE) == 0) {
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            struct stat st;
+            size_t capacity = 0;
+            if (fstat(fd, &st) != 0 ||
+                read_targets(fd, 0, st.st_size, &store->targets, &store->target_count, &capacity) < 0) {
+                close(fd);
+                history_store_close(store);
+                return -1;
+            }
+            close(fd);
+        }
+    }
+    return 0;
+}
+
+/* Maps the complete rows of a column on first use; a store with no rows maps nothing */
+static int store_map_column(HistoryStore *store, int column) {
+    if (store->columns[column] != NULL || store->row_count == 0) {
+        return 0;
+    }
+    size_t size = store->row_count * column_defs[column].width;
+    void *mapped = mmap(NULL, size, PROT_READ, MAP_SHARED, store->column_fds[column], 0);
+    if (mapped == MAP_FAILED) {
+        return -1;
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    store->columns[column] = mapped;
+    store->mapped_sizes[column] = size;
+    close(store->column_fds[column]);
+    store->column_fds[column] = -1;
+    return 0;
+}
+
+void history_store_close(HistoryStore *store) {
+    if (store == NULL) {
+        return;
+    }
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++) {
+        if (store->columns[c] != NULL) {
+            munmap((void *)store->columns[c], store->mapped_sizes[c]);
+        }
+        if (store->column_fds[c] >= 0) {
+            close(store->column_fds[c]);
+        }
+    }
+    free_targets(store->targets, store->target_count);
+    memset(store, 0, sizeof(*store));
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++) {
+        store->column_fds[c] = -1;
+    }
+}
+
+int history_column_from_name(const char *name) {
+    if (name == NULL) {
+        return -1;
+    }
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++) {
+        if (strcmp(name, column_defs[c].name) == 0) {
+            return c;
+        }
+    }
+    if (strcmp(name, "day") == 0) {
+        return HISTORY_GROUP_DAY;
+    }
+    return -1;
+}
+
+const char *history_column_name(int column) {
+    if (column >= 0 && column < HISTORY_COLUMN_COUNT) {
+        return column_defs[column].name;
+    }
+    if (column == HISTORY_GROUP_DAY) {
+        return "day";
+    }
+    return "unknown";
+}
+
+int64_t history_target_id(const HistoryStore *store, const char *name) {
+    for (size_t i = 0; i < store->target_count; i++) {
+        if (strcmp(store->targets[i], name) == 0) {
+            return (int64_t)i;
+        }
+    }
+    return -1;
+}
+
+const char *history_target_name(const HistoryStore *store, int64_t id) {
+    if (id < 0 || (uint64_t)id >= store->target_count) {
+        return NULL;
+    }
+    return store->targets[id];
+}
+
+/* Open-addressing hash table for group-by counts */
+typedef struct {
+    int64_t *keys;
+    uint64_t *counts;
+    uint8_t *used;
+    size_t capacity;                /* Power of two */
+    size_t size;
+} GroupTable;
+
+static int group_table_init(GroupTable *table, size_t capacity) {
+    table->keys = malloc(capacity * sizeof(*table->keys));
+    table->counts = calloc(capacity, sizeof(*table->counts));
+    table->used = calloc(capacity, sizeof(*table->used));
+    table->capacity = capacity;
+    table->size = 0;
+    if (table->keys == NULL || table->counts == NULL || table->used == NULL) {
+        free(table->keys);
+        free(table->counts);
+        free(table->used);
+        return -1;
+    }
+    return 0;
+}
+
+static void group_table_free(GroupTable *table) {
+    free(table->keys);
+    free(table->counts);
+    free(table->used);
+}
+
+static size_t group_slot(const GroupTable *table, int64_t key) {
+    uint64_t h = (uint64_t)key * 0x9E3779B97F4A7C15ULL;
+    size_t mask = table->capacity - 1;
+    size_t slot = (size_t)(h >> 32) & mask;
+    while (table->used[slot] && table->keys[slot] != key) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static int group_table_add(GroupTable *table, int64_t key, uint64_t count) {
+    size_t slot = group_slot(table, key);
+    if (!table->used[slot]) {
+        if ((table->size + 1) * 2 > table->capacity) {
+            GroupTable grown;
+            if (group_table_init(&grown, table->capacity * 2) != 0) {
+                return -1;
+            }
+            for (size_t i = 0; i < table->capacity; i++) {
+                if (table->used[i]) {
+                    size_t s = group_slot(&grown, table->keys[i]);
+                    grown.used[s] = 1;
+                    grown.keys[s] = table->keys[i];
+                    grown.counts[s] = table->counts[i];
+                    grown.size++;
+                }
+            }
+            group_table_free(table);
+            *table = grown;
+            slot = group_slot(table, key);
+        }
+        table->used[slot] = 1;
+        table->keys[slot] = key;
+        table->counts[slot] = 0;
+        table->size++;
+    }
+    table->counts[slot] += count;
+    return 0;
+}
+
+static int compare_groups(const void *a, const void *b) {
+    int64_t ka = ((const HistoryGroup *)a)->key;
+    int64_t kb = ((const HistoryGroup *)b)->key;
+    return (ka > kb) - (ka < kb);
+}
+
+/* First row in [0, rows) whose timestamp is >= value (timestamps are appended in order) */
+static size_t lower_bound(const int64_t *timestamps, size_t rows, int64_t value) {
+    size_t lo = 0;
+    size_t hi = rows;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (timestamps[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+#define APPLY_FILTER(type)                                                     \
+    do {                                                                       \
+        const type *col = (const type *)base + start;                          \
+        type v = (type)filter->value;                                          \
+        if ((int64_t)v != filter->value) {                                     \
+            memset(mask, 0, count);                                            \
+        } else {                                                               \
+            for (size_t i = 0; i < count; i++) {                               \
+                mask[i] &= (uint8_t)(col[i] == v);                             \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+
+static void apply_filter(const HistoryStore *store, const HistoryFilter *filter,
+                         size_t start, size_t count, uint8_t *mask) {
+    const void *base = store->columns[filter->column];
+    switch (column_defs[filter->column].storage) {
+        case STORAGE_INT8:
+            APPLY_FILTER(int8_t);
+            break;
+        case STORAGE_UINT8:
+            APPLY_FILTER(uint8_t);
+            break;
+        case STORAGE_INT16:
+            APPLY_FILTER(int16_t);
+            break;
+        case STORAGE_UINT32:
+            APPLY_FILTER(uint32_t);
+            break;
+        case STORAGE_INT64:
+            APPLY_FILTER(int64_t);
+            break;
+        case STORAGE_UINT64: {
+            /* Signatures are compared bit-for-bit */
+            const uint64_t *col = (const uint64_t *)base + start;
+            uint64_t v = (uint64_t)filter->value;
+            for (size_t i = 0; i < count; i++) {
+                mask[i] &= (uint8_t)(col[i] == v);
+            }
+            break;
+        }
+    }
+}
+
+/* Groups consecutive equal keys before touching the hash table */
+#define GROUP_ROWS(type, key_expr)                                             \
+    do {                                                                       \
+        const type *col = (const type *)base + start;                          \
+        for (size_t i = 0; i < count; i++) {                                   \
+            if (!mask[i]) {                                                    \
+                continue;                                                      \
+            }                                                                  \
+            int64_t key = (key_expr);                                          \
+            if (have_run && key == run_key) {                                  \
+                run_count++;                                                   \
+                continue;                                                      \
+            }                                                                  \
+            if (have_run && group_table_add(table, run_key, run_count) != 0) { \
+                return -1;                                                     \
+            }                                                                  \
+            have_run = 1;                                                      \
+            run_key = key;                                                     \
+            run_count = 1;                                                     \
+        }                                                                      \
+    } while (0)
+
+static int group_block(const HistoryStore *store, int group_by, size_t start, size_t count,
+                       const uint8_t *mask, GroupTable *table) {
+    int column = group_by == HISTORY_GROUP_DAY ? HISTORY_COL_TIMESTAMP : group_by;
+    const void *base = store->columns[column];
+    int have_run = 0;
+    int64_t run_key = 0;
+    uint64_t run_count = 0;
+
+    if (group_by == HISTORY_GROUP_DAY) {
+        GROUP_ROWS(int64_t, col[i] >= 0 ? col[i] / SECONDS_PER_DAY
+                                        : -((-col[i] + SECONDS_PER_DAY - 1) / SECONDS_PER_DAY));
+    } else {
+        switch (column_defs[column].storage) {
+            case STORAGE_INT8:
+                GROUP_ROWS(int8_t, col[i]);
+                break;
+            case STORAGE_UINT8:
+                GROUP_ROWS(uint8_t, col[i]);
+                break;
+            case STORAGE_INT16:
+                GROUP_ROWS(int16_t, col[i]);
+                break;
+            case STORAGE_UINT32:
+                GROUP_ROWS(uint32_t, col[i]);
+                break;
+            case STORAGE_INT64:
+                GROUP_ROWS(int64_t, col[i]);
+                break;
+            case STORAGE_UINT64:
+                GROUP_ROWS(uint64_t, (int64_t)col[i]);
+                break;
+        }
+    }
+
+    if (have_run && group_table_add(table, run_key, run_count) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Narrow columns (1-2 bytes) and target ids are grouped into a dense count
+ * array indexed by the raw value instead of the hash table */
+#define DENSE_GROUP_SLOTS 65536
+
+#define DENSE_GROUP_ROWS(type, index_type)                                     \
+    do {                                                                       \
+        const type *col = (const type *)base + start;                          \
+        for (size_t i = 0; i < count; i++) {                                   \
+            dense[(index_type)col[i]] += mask[i];                              \
+        }                                                                      \
+    } while (0)
+
+static void dense_group_block(const HistoryStore *store, int column, size_t start, size_t count,
+                              const uint8_t *mask, uint64_t *dense) {
+    const void *base = store->columns[column];
+    switch (column_defs[column].storage) {
+        case STORAGE_INT8:
+            DENSE_GROUP_ROWS(int8_t, uint8_t);
+            break;
+        case STORAGE_UINT8:
+            DENSE_GROUP_ROWS(uint8_t, uint8_t);
+            break;
+        case STORAGE_INT16:
+            DENSE_GROUP_ROWS(int16_t, uint16_t);
+            break;
+        case STORAGE_UINT32: {
+            /* Target ids are bounded by the dictionary size seen at open time */
+            const uint32_t *col = (const uint32_t *)base + start;
+            for (size_t i = 0; i < count; i++) {
+                dense[col[i] < store->target_count ? col[i] : store->target_count] += mask[i];
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static int64_t dense_key(int column, size_t index) {
+    switch (column_defs[column].storage) {
+        case STORAGE_INT8:
+            return (int8_t)(uint8_t)index;
+        case STORAGE_INT16:
+            return (int16_t)(uint16_t)index;
+        default:
+            return (int64_t)index;
+    }
+}
+
+int history_query(HistoryStore *store, const HistoryQuery *query, HistoryQueryResult *result) {
+    if (store == NULL || query == NULL || result == NULL || query->filter_count > HISTORY_MAX_FILTERS) {
+        return -1;
+    }
+    memset(result, 0, sizeof(*result));
+    if (query->group_by != HISTORY_GROUP_NONE &&
+        (query->group_by < 0 || query->group_by > HISTORY_GROUP_DAY)) {
+        return -1;
+    }
+    for (size_t f = 0; f < query->filter_count; f++) {
+        if ((int)query->filters[f].column < 0 || query->filters[f].column >= HISTORY_COLUMN_COUNT) {
+            return -1;
+        }
+    }
+    if (store->row_count == 0) {
+        return 0;
+    }
+
+    /* Map only the columns this query reads */
+    int ranged = query->since != INT64_MIN || query->until != INT64_MAX;
+    if ((ranged || query->group_by == HISTORY_GROUP_DAY) && store_map_column(store, HISTORY_COL_TIMESTAMP) != 0) {
+        return -1;
+    }
+    if (query->group_by != HISTORY_GROUP_NONE && query->group_by != HISTORY_GROUP_DAY &&
+        store_map_column(store, query->group_by) != 0) {
+        return -1;
+    }
+    for (size_t f = 0; f < query->filter_count; f++) {
+        if (store_map_column(store, query->filters[f].column) != 0) {
+            return -1;
+        }
+    }
+
+    /* Time range narrows the scan by binary search instead of a filter pass */
+    const int64_t *timestamps = store->columns[HISTORY_COL_TIMESTAMP];
+    size_t first = query->since == INT64_MIN ? 0 : lower_bound(timestamps, store->row_count, query->since);
+    size_t last = query->until == INT64_MAX ? store->row_count
+                                            : lower_bound(timestamps, store->row_count, query->until + 1);
+    if (last < first) {
+        last = first;
+    }
+    result->rows_scanned = last - first;
+
+    GroupTable table;
+    int grouping = query->group_by != HISTORY_GROUP_NONE;
+    uint64_t *dense = NULL;
+    if (grouping && group_table_init(&table, 64) != 0) {
+        return -1;
+    }
+    size_t dense_slots = 0;
+    if (grouping && query->group_by == HISTORY_COL_TARGET) {
+        dense_slots = store->target_count + 1;  /* Last slot collects ids beyond the dictionary */
+    } else if (grouping && query->group_by != HISTORY_GROUP_DAY && column_defs[query->group_by].width <= 2) {
+        dense_slots = DENSE_GROUP_SLOTS;
+    }
+    if (dense_slots > 0) {
+        dense = calloc(dense_slots, sizeof(*dense));
+        if (dense == NULL) {
+            group_table_free(&table);
+            return -1;
+        }
+    }
+
+    uint8_t mask[SCAN_BLOCK_ROWS];
+    for (size_t start = first; start < last; start += SCAN_BLOCK_ROWS) {
+        size_t count = last - start < SCAN_BLOCK_ROWS ? last - start : SCAN_BLOCK_ROWS;
+        memset(mask, 1, count);
+        for (size_t f = 0; f < query->filter_count; f++) {
+            apply_filter(store, &query->filters[f], start, count, mask);
+        }
+
+        uint64_t matched = 0;
+        for (size_t i = 0; i < count; i++) {
+            matched += mask[i];
+        }
+        result->rows_matched += matched;
+
+        if (dense != NULL && matched > 0) {
+            dense_group_block(store, query->group_by, start, count, mask, dense);
+        } else if (grouping && matched > 0 &&
+                   group_block(store, query->group_by, start, count, mask, &table) != 0) {
+            group_table_free(&table);
+            return -1;
+        }
+    }
+
+    if (dense != NULL) {
+        for (size_t i = 0; i < dense_slots; i++) {
+            if (dense[i] > 0 && group_table_add(&table, dense_key(query->group_by, i), dense[i]) != 0) {
+                free(dense);
+                group_table_free(&table);
+                return -1;
+            }
+        }
+        free(dense);
+    }
+
+    if (grouping) {
+        if (table.size > 0) {
+            result->groups = malloc(table.size * sizeof(*result->groups));
+            if (result->groups == NULL) {
+                group_table_free(&table);
+                return -1;
+            }
+            for (size_t i = 0; i < table.capacity; i++) {
+                if (table.used[i]) {
+                    result->groups[result->group_count].key = table.keys[i];
+                    result->groups[result->group_count].count = table.counts[i];
+                    result->group_count++;
+                }
+            }
+            qsort(result->groups, result->group_count, sizeof(*result->groups), compare_groups);
+        }
+        group_table_free(&table);
+    }
+    return 0;
+}
+
+void history_query_result_free(HistoryQueryResult *result) {
+    if (result == NULL) {
+        return;
+    }
+    free(result->groups);
+    memset(result, 0, sizeof(*result));
+}
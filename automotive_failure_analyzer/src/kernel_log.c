@@ -0,0 +1,321 @@
+#define _GNU_SOURCE
+#include "kernel_log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define KERNEL_COMM_LEN 16              /* TASK_COMM_LEN, including the terminator */
+#define KMSG_RECORD_SIZE 8192           /* Larger than any single /dev/kmsg record */
+
+int kernel_log_open(KernelLogCursor *cursor) {
+    if (cursor == NULL) {
+        return -1;
+    }
+
+    /* Non-blocking so collection stops at the newest record instead of waiting */
+    cursor->fd = open("/dev/kmsg", O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (cursor->fd < 0) {
+        return -1;
+    }
+
+    /* Skip all existing records; this is O(1) however large the log is */
+    if (lseek(cursor->fd, 0, SEEK_END) < 0) {
+        close(cursor->fd);
+        cursor->fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+void kernel_log_close(KernelLogCursor *cursor) {
+    if (cursor != NULL && cursor->fd >= 0) {
+        close(cursor->fd);
+        cursor->fd = -1;
+    }
+}
+
+/* The kernel names a task by the base name of the executed file, truncated */
+static void program_comm(const char *program, char *comm) {
+    const char *base = strrchr(program, '/');
+    base = base != NULL ? base + 1 : program;
+    snprintf(comm, KERNEL_COMM_LEN, "%s", base);
+}
+
+static int task_matches(const char *comm, size_t comm_length, long task_pid, int pid, const char *expected_comm) {
+    return task_pid == pid && comm_length == strlen(expected_comm) &&
+           strncmp(comm, expected_comm, comm_length) == 0;
+}
+
+/* Matches "<comm>[<pid>]" where msg starts the comm and close points at the ']' */
+static int bracket_task_matches(const char *msg, const char *close, int pid, const char *expected_comm) {
+    const char *open = close;
+    while (open > msg && *open != '[') {
+        open--;
+    }
+    if (*open != '[') {
+        return 0;
+    }
+    return task_matches(msg, (size_t)(open - msg), strtol(open + 1, NULL, 10), pid, expected_comm);
+}
+
+/* Returns the number following key in msg, or 0 if key is absent */
+static unsigned long field_value(const char *msg, const char *key, int base) {
+    const char *p = strstr(msg, key);
+    return p != NULL ? strtoul(p + strlen(key), NULL, base) : 0;
+}
+
+static void set_fault_kind(KernelEvents *events, const char *kind, size_t length) {
+    if (length >= sizeof(events->fault_kind)) {
+        length = sizeof(events->fault_kind) - 1;
+    }
+    memcpy(events->fault_kind, kind, length);
+    events->fault_kind[length] = '\0';
+    events->has_fault = 1;
+}
+
+/* x86: "<comm>[<pid>]: segfault at <addr> ip <ip> sp <sp> error <code> in ..." */
+static int match_segfault(const char *msg, int pid, const char *comm, KernelEvents *events) {
+    const char *marker = strstr(msg, "]: segfault at ");
+    if (marker == NULL || !bracket_task_matches(msg, marker, pid, comm)) {
+        return 0;
+    }
+    set_fault_kind(events, "segfault", strlen("segfault"));
+    events->has_fault_address = 1;
+    events->fault_address = strtoul(marker + strlen("]: segfault at "), NULL, 16);
+    events->fault_ip = field_value(marker, " ip ", 16);
+    events->fault_error = field_value(marker, " error ", 16);
+    return 1;
+}
+
+/* x86: "traps: <comm>[<pid>] trap divide error ip:<ip> sp:<sp> error:<code> in ..." */
+static int match_trap(const char *msg, int pid, const char *comm, KernelEvents *events) {
+    if (strncmp(msg, "traps: ", 7) != 0) {
+        return 0;
+    }
+    msg += 7;
+    const char *close = strstr(msg, "] ");
+    const char *ip = strstr(msg, " ip:");
+    if (close == NULL || ip == NULL || ip < close || !bracket_task_matches(msg, close, pid, comm)) {
+        return 0;
+    }
+    const char *kind = close + 2;
+    if (strncmp(kind, "trap ", 5) == 0) {
+        kind += 5;
+    }
+    set_fault_kind(events, kind, (size_t)(ip - kind));
+    events->fault_ip = field_value(ip, " ip:", 16);
+    events->fault_error = field_value(ip, " error:", 16);
+    return 1;
+}
+
+/* arm64: "<comm>[<pid>]: unhandled level 1 translation fault (11) at 0x..., esr 0x..., in ..." */
+static int match_unhandled_fault(const char *msg, int pid, const char *comm, KernelEvents *events) {
+    const char *marker = strstr(msg, "]: unhandled ");
+    if (marker == NULL || !bracket_task_matches(msg, marker, pid, comm)) {
+        return 0;
+    }
+    const char *kind = marker + 3;
+    const char *at = strstr(kind, " at 0x");
+    if (at == NULL) {
+        return 0;
+    }
+    const char *paren = strstr(kind, " (");
+    set_fault_kind(events, kind, (size_t)((paren != NULL && paren < at ? paren : at) - kind));
+    events->has_fault_address = 1;
+    events->fault_address = strtoul(at + 4, NULL, 16);
+    events->fault_error = field_value(at, "esr 0x", 16);
+    return 1;
+}
+
+/* "[Memory cgroup out of memory|Out of memory]: Killed process <pid> (<comm>) total-vm:<n>kB, anon-rss:<n>kB, ..." */
+static int match_oom_kill(const char *msg, int pid, const char *comm, KernelEvents *events) {
+    const char *marker = strstr(msg, "Killed process ");
+    if (marker == NULL || strstr(marker, "total-vm:") == NULL) {
+        return 0;
+    }
+    char *end;
+    long task_pid = strtol(marker + strlen("Killed process "), &end, 10);
+    if (strncmp(end, " (", 2) != 0) {
+        return 0;
+    }
+    const char *name = end + 2;
+    const char *close = strstr(name, ") total-vm:");
+    if (close == NULL) {
+        close = strchr(name, ')');
+    }
+    if (close == NULL || !task_matches(name, (size_t)(close - name), task_pid, pid, comm)) {
+        return 0;
+    }
+    events->oom_killed = 1;
+    if (strncmp(msg, "Memory cgroup", 13) == 0) {
+        events->oom_memcg = 1;
+    }
+    events->oom_total_vm_kb = field_value(close, "total-vm:", 10);
+    events->oom_anon_rss_kb = field_value(close, "anon-rss:", 10);
+    events->oom_file_rss_kb = field_value(close, "file-rss:", 10);
+    events->oom_shmem_rss_kb = field_value(close, "shmem-rss:", 10);
+    const char *adj = strstr(close, "oom_score_adj:");
+    events->oom_score_adj = adj != NULL ? (int)strtol(adj + strlen("oom_score_adj:"), NULL, 10) : 0;
+    return 1;
+}
+
+/* "oom-kill:constraint=CONSTRAINT_MEMCG,...,task=<comm>,pid=<pid>,uid=<uid>" */
+static int match_oom_constraint(const char *msg, int pid, const char *comm, KernelEvents *events) {
+    if (strncmp(msg, "oom-kill:constraint=", 20) != 0) {
+        return 0;
+    }
+    const char *task = strstr(msg, ",task=");
+    const char *task_pid = task != NULL ? strstr(task, ",pid=") : NULL;
+    if (task_pid == NULL) {
+        return 0;
+    }
+    task += strlen(",task=");
+    if (!task_matches(task, (size_t)(task_pid - task), strtol(task_pid + 5, NULL, 10), pid, comm)) {
+        return 0;
+    }
+    if (strncmp(msg + 20, "CONSTRAINT_MEMCG", 16) == 0) {
+        events->oom_memcg = 1;
+    }
+    return 1;
+}
+
+/* "INFO: task <comm>:<pid> blocked for more than <n> seconds." */
+static int match_hung_task(const char *msg, int pid, const char *comm, KernelEvents *events) {
+    if (strncmp(msg, "INFO: task ", 11) != 0) {
+        return 0;
+    }
+    const char *name = msg + 11;
+    const char *marker = strstr(name, " blocked for more than ");
+    if (marker == NULL) {
+        return 0;
+    }
+    const char *colon = marker;
+    while (colon > name && *colon != ':') {
+        colon--;
+    }
+    if (*colon != ':' || !task_matches(name, (size_t)(colon - name), strtol(colon + 1, NULL, 10), pid, comm)) {
+        return 0;
+    }
+    events->hung_task = 1;
+    events->hung_seconds = strtoul(marker + strlen(" blocked for more than "), NULL, 10);
+    return 1;
+}
+
+int kernel_log_collect(KernelLogCursor *cursor, int pid, const char *program, KernelEvents *events) {
+    if (cursor == NULL || program == NULL || events == NULL) {
+        return -1;
+    }
+    memset(events, 0, sizeof(*events));
+    if (cursor->fd < 0) {
+        return -1;
+    }
+
+    char comm[KERNEL_COMM_LEN];
+    program_comm(program, comm);
+
+    char record[KMSG_RECORD_SIZE];
+    unsigned long long last_seq = 0;
+    int have_seq = 0;
+    int overrun = 0;
+
+    /* Every new record is scanned, but only the matching reports are kept */
+    for (;;) {
+        ssize_t n = read(cursor->fd, record, sizeof(record) - 1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EPIPE) {
+                /* Records were overwritten; the next read resumes at the oldest one left */
+                overrun = 1;
+                continue;
+            }
+            if (errno == EAGAIN) {
+                break;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        record[n] = '\0';
+        events->records_read++;
+
+        /* "<prio>,<seq>,<usec>,<flags>[,...];<message>\n[ KEY=value\n]..." */
+        const char *seq_field = strchr(record, ',');
+        unsigned long long seq = seq_field != NULL ? strtoull(seq_field + 1, NULL, 10) : 0;
+        if (have_seq) {
+            /* The gap after the previous record counts every record lost, EPIPE or not */
+            if (seq > last_seq + 1) {
+                events->records_lost += (size_t)(seq - last_seq - 1);
+            }
+        } else if (overrun) {
+            /* Overwritten before the first read: the cursor's start is unknown, so count one */
+            events->records_lost++;
+        }
+        overrun = 0;
+        have_seq = 1;
+        last_seq = seq;
+
+        char *msg = strchr(record, ';');
+        if (msg == NULL) {
+            continue;
+        }
+        msg++;
+        char *end = strchr(msg, '\n');
+        if (end != NULL) {
+            *end = '\0';
+        }
+
+        if (!events->has_fault &&
+            (match_segfault(msg, pid, comm, events) || match_trap(msg, pid, comm, events) ||
+             match_unhandled_fault(msg, pid, comm, events))) {
+            continue;
+        }
+        if (match_oom_kill(msg, pid, comm, events) || match_oom_constraint(msg, pid, comm, events)) {
+            continue;
+        }
+        match_hung_task(msg, pid, comm, events);
+    }
+    if (overrun) {
+        events->records_lost++;
+    }
+    return 0;
+}
+
+void kernel_fault_describe(const KernelEvents *events, char *buffer, size_t size) {
+    if (buffer == NULL || size == 0) {
+        return;
+    }
+    if (events == NULL || !events->has_fault) {
+        buffer[0] = '\0';
+        return;
+    }
+
+    int length = events->has_fault_address
+                     ? snprintf(buffer, size, "%s at 0x%lx", events->fault_kind, events->fault_address)
+                     : snprintf(buffer, size, "%s", events->fault_kind);
+    if (length < 0 || (size_t)length >= size) {
+        return;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (events->has_fault_address) {
+        unsigned long error = events->fault_error;
+        snprintf(buffer + length, size - (size_t)length, " (ip 0x%lx, error %lx: %s %s, %s)",
+                 events->fault_ip, error,
+                 (error & KERNEL_FAULT_USER) ? "user-mode" : "kernel-mode",
+                 (error & KERNEL_FAULT_INSTRUCTION) ? "instruction fetch" : (error & KERNEL_FAULT_WRITE) ? "write" : "read",
+                 (error & KERNEL_FAULT_PROTECTION) ? "protection violation" : "page not present");
+        return;
+    }
+#endif
+    if (events->fault_ip != 0) {
+        snprintf(buffer + length, size - (size_t)length, " (ip 0x%lx, error 0x%lx)", events->fault_ip, events->fault_error);
+    } else {
+        snprintf(buffer + length, size - (size_t)length, " (error 0x%lx)", events->fault_error);
+    }
+}
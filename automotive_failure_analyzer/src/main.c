@@ -9,40 +9,152 @@
 #include "log_parser.h"
 #include "failure_rules.h"
 #include "process_runner.h"
+#include "kernel_log.h"
+#include "pattern_dict.h"
+#include "history_store.h"
+#include "query_command.h"
+#include "manifest_runner.h"
+#include "sys_tables.h"
 
-static const char *failure_type_to_string(FailureType type) {
-    switch (type) {
-        case FAILURE_MEMORY_CORRUPTION:
-            return "Memory Corruption";
-        case FAILURE_INVALID_STATE:
-            return "Invalid State";
-        case FAILURE_RESOURCE_EXHAUSTION:
-            return "Resource Exhaustion";
-        case FAILURE_TIMING_RACE:
-            return "Timing/Race";
-        default:
-            return "Unknown";
+/* Appends one analysis result to the history store, if one is configured */
+static void record_history(const char *history_dir, const char *target, int signal_num, int err_val,
+                           int exit_code, int failure_type, int rule_id) {
+    if (history_dir == NULL) {
+        return;
     }
+
+    HistoryRecord record = {
+        .timestamp = 0,
+        .target = target,
+        .signal_num = signal_num,
+        .err_val = err_val,
+        .exit_code = exit_code,
+        .failure_type = failure_type,
+        .rule_id = rule_id
+    };
+
+    HistoryWriter writer;
+    if (history_writer_open(history_dir, &writer) != 0 ||
+        history_writer_append(&writer, &record) != 0) {
+        fprintf(stderr, "Warning: Failed to record history in %s: %s\n", history_dir, strerror(errno));
+    }
+    history_writer_close(&writer);
 }
 
 void print_usage(const char *program_name) {
-    fprintf(stderr, "Usage: %s [-s <signal>] [-e <errno>] [-l <log_file>] [--run <program> [args...]]\n", program_name);
+    fprintf(stderr, "Usage: %s [-s <signal>] [-e <errno>] [-l <log_file>] [-d <dict_file>] [-H <history_dir>] [-t <target>] [--trace-errno[=<syscalls>]] [--run <program> [args...]]\n", program_name);
+    fprintf(stderr, "       %s --manifest <file> [-j <workers>] [--timeout <seconds>] [--junit <file>]\n", program_name);
+    fprintf(stderr, "       %s query [-H <history_dir>] [-w <column>=<value>]... [-g <column>] [--since <epoch>] [--until <epoch>]\n", program_name);
     fprintf(stderr, "Options:\n");
     fprintf(stderr, "  -s <int>       Signal number (e.g., 11 for SIGSEGV)\n");
     fprintf(stderr, "  -e <int>       Errno value (e.g., 14 for EFAULT)\n");
     fprintf(stderr, "  -l <path>      Path to log file\n");
+    fprintf(stderr, "  -d <path>      Pattern dictionary file for log scoring\n");
+    fprintf(stderr, "  -H <dir>       Append results to a history store (default: $AUTO_ANALYZE_HISTORY)\n");
+    fprintf(stderr, "  -t <name>      Target name recorded in history (default: program or log path)\n");
     fprintf(stderr, "  --run <prog>   Run and monitor a program\n");
+    fprintf(stderr, "  --trace-errno[=<syscalls>]\n");
+    fprintf(stderr, "                 With --run, capture the errno of failing syscalls (comma-separated\n");
+    fprintf(stderr, "                 list; default: mmap,mremap,brk,mprotect,write,writev)\n");
+    fprintf(stderr, "  --manifest <file>  Run the tests listed in a manifest concurrently\n");
+    fprintf(stderr, "  -j <int>       Maximum concurrent manifest tests (default: 2 per CPU)\n");
+    fprintf(stderr, "  --timeout <s>  Default per-test timeout for manifest tests (default: 30)\n");
+    fprintf(stderr, "  --junit <file> Write manifest results as JUnit XML\n");
+}
+
+/* Prints the last failing traced syscall of a --run target, if any */
+static void print_traced_syscall(const ProcessResult *proc_result) {
+    if (!proc_result->syscalls_traced) {
+        return;
+    }
+    if (proc_result->syscall_errno == 0) {
+        printf("- Failed syscalls: none\n");
+        return;
+    }
+
+    const char *name = syscall_name(proc_result->failed_syscall);
+    const ErrnoInfo *err_info = analyze_errno(proc_result->syscall_errno);
+    printf("- Last failed syscall: %s", name != NULL ? name : "unknown");
+    if (err_info != NULL) {
+        printf(" (%s)\n", err_info->name);
+    } else {
+        printf(" (errno %d)\n", proc_result->syscall_errno);
+    }
+    printf("- Failed syscalls: %lu\n", proc_result->syscall_failures);
+}
+
+/* Prints the si_code of the terminating signal, if the tracer captured it */
+static void print_signal_code(const ProcessResult *proc_result) {
+    if (!proc_result->has_signal_info) {
+        return;
+    }
+
+    const SiCodeInfo *code_info = analyze_si_code(proc_result->signal_number, proc_result->signal_code);
+    if (code_info != NULL) {
+        printf("- Signal code: %s (%s)", code_info->name, code_info->description);
+    } else {
+        printf("- Signal code: %d", proc_result->signal_code);
+    }
+    if (proc_result->signal_sender == proc_result->pid) {
+        printf(", raised by the program itself\n");
+    } else if (proc_result->signal_sender != 0) {
+        printf(", sent by PID %d\n", proc_result->signal_sender);
+    } else if (proc_result->has_fault_address) {
+        printf(", address 0x%lx\n", proc_result->fault_address);
+    } else {
+        printf("\n");
+    }
+}
+
+/* Prints what the kernel log reported about a --run target, if anything */
+static void print_kernel_events(const KernelEvents *kernel) {
+    if (kernel == NULL) {
+        return;
+    }
+    if (kernel->has_fault) {
+        char fault[192];
+        kernel_fault_describe(kernel, fault, sizeof(fault));
+        printf("- Kernel: %s\n", fault);
+    }
+    if (kernel->oom_killed) {
+        printf("- Kernel: killed by the OOM killer%s (total-vm %lu kB, anon-rss %lu kB, file-rss %lu kB, "
+               "shmem-rss %lu kB, oom_score_adj %d)\n",
+               kernel->oom_memcg ? " for a memory cgroup" : "", kernel->oom_total_vm_kb, kernel->oom_anon_rss_kb,
+               kernel->oom_file_rss_kb, kernel->oom_shmem_rss_kb, kernel->oom_score_adj);
+    }
+    if (kernel->hung_task) {
+        printf("- Kernel: hung task, blocked for more than %lu seconds\n", kernel->hung_seconds);
+    }
+    if (kernel->records_lost > 0) {
+        printf("- Kernel log: %zu records overwritten before they could be read\n", kernel->records_lost);
+    }
 }
 
 int main(int argc, char *argv[]) {
     int signal_num = -1;
     int err_val = 0;
     const char *log_file = NULL;
+    const char *dict_file = NULL;
+    const char *history_dir = getenv("AUTO_ANALYZE_HISTORY");
+    const char *target_name = NULL;
     int use_run_mode = 0;
+    int trace_errno = 0;
+    const char *trace_syscalls = NULL;
+    int exit_code = -1;
+    const char *manifest_file = NULL;
+    ManifestOptions manifest_options = {NULL, 0, 0};
+    KernelEvents kernel_events;
+    const KernelEvents *kernel = NULL;
+    const SiCodeInfo *si_code = NULL;
     char *run_program = NULL;
     char **run_args = NULL;
     int run_args_count = 0;
 
+    /* Subcommand: query the history store */
+    if (argc > 1 && strcmp(argv[1], "query") == 0) {
+        return run_query_command(argc - 1, argv + 1, history_dir);
+    }
+
     /* Manual argument parsing to handle --run specially */
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--run") == 0) {
@@ -61,6 +173,31 @@ int main(int argc, char *argv[]) {
             }
             /* Skip processing --run and its arguments */
             i = argc;  /* Exit loop */
+        } else if (strcmp(argv[i], "--manifest") == 0 || strcmp(argv[i], "--junit") == 0 ||
+                   strcmp(argv[i], "--timeout") == 0) {
+            /* Manifest mode options with an argument */
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: Option %s requires an argument\n", argv[i]);
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (strcmp(argv[i], "--manifest") == 0) {
+                manifest_file = argv[i + 1];
+            } else if (strcmp(argv[i], "--junit") == 0) {
+                manifest_options.junit_file = argv[i + 1];
+            } else {
+                manifest_options.timeout = atof(argv[i + 1]);
+                if (manifest_options.timeout <= 0) {
+                    fprintf(stderr, "Error: Invalid timeout: %s\n", argv[i + 1]);
+                    return EXIT_FAILURE;
+                }
+            }
+            i++;  /* Skip argument */
+        } else if (strcmp(argv[i], "--trace-errno") == 0) {
+            trace_errno = 1;
+        } else if (strncmp(argv[i], "--trace-errno=", 14) == 0) {
+            trace_errno = 1;
+            trace_syscalls = argv[i] + 14;
         } else if (argv[i][0] == '-' && strlen(argv[i]) == 2) {
             /* Short option */
             if (i + 1 >= argc) {
@@ -71,16 +208,19 @@ int main(int argc, char *argv[]) {
             switch (argv[i][1]) {
                 case 's':
                     signal_num = atoi(argv[i + 1]);
-                    if (signal_num <= 0 || signal_num > 64) {
-                        fprintf(stderr, "Error: Invalid signal number: %d (valid range: 1-64)\n", signal_num);
+                    /* Range comes from the signal table generated from the host headers */
+                    if (signal_num <= 0 || (size_t)signal_num >= sys_signal_table_size) {
+                        fprintf(stderr, "Error: Invalid signal number: %d (valid range: 1-%zu)\n",
+                                signal_num, sys_signal_table_size - 1);
                         return EXIT_FAILURE;
                     }
                     i++;  /* Skip argument */
                     break;
                 case 'e':
                     err_val = atoi(argv[i + 1]);
-                    if (err_val < 0 || err_val > 255) {
-                        fprintf(stderr, "Error: Invalid errno value: %d (valid range: 0-255)\n", err_val);
+                    if (err_val < 0 || (size_t)err_val >= sys_errno_table_size) {
+                        fprintf(stderr, "Error: Invalid errno value: %d (valid range: 0-%zu)\n",
+                                err_val, sys_errno_table_size - 1);
                         return EXIT_FAILURE;
                     }
                     i++;  /* Skip argument */
@@ -89,6 +229,26 @@ int main(int argc, char *argv[]) {
                     log_file = argv[i + 1];
                     i++;  /* Skip argument */
                     break;
+                case 'd':
+                    dict_file = argv[i + 1];
+                    i++;  /* Skip argument */
+                    break;
+                case 'H':
+                    history_dir = argv[i + 1];
+                    i++;  /* Skip argument */
+                    break;
+                case 't':
+                    target_name = argv[i + 1];
+                    i++;  /* Skip argument */
+                    break;
+                case 'j':
+                    manifest_options.workers = atoi(argv[i + 1]);
+                    if (manifest_options.workers <= 0) {
+                        fprintf(stderr, "Error: Invalid worker count: %s\n", argv[i + 1]);
+                        return EXIT_FAILURE;
+                    }
+                    i++;  /* Skip argument */
+                    break;
                 default:
                     fprintf(stderr, "Error: Unknown option: %s\n", argv[i]);
                     print_usage(argv[0]);
@@ -102,6 +262,34 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    /* A dictionary only affects log scoring */
+    if (dict_file != NULL && log_file == NULL) {
+        fprintf(stderr, "Error: -d requires a log file (-l)\n");
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Worker, timeout and JUnit options only affect manifest runs */
+    if (manifest_file == NULL &&
+        (manifest_options.workers != 0 || manifest_options.timeout != 0 || manifest_options.junit_file != NULL)) {
+        fprintf(stderr, "Error: -j, --timeout and --junit require --manifest\n");
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Manifest mode: run a regression suite instead of a single analysis */
+    if (manifest_file != NULL) {
+        if (use_run_mode) {
+            fprintf(stderr, "Error: --manifest cannot be combined with --run\n");
+            return EXIT_FAILURE;
+        }
+        return run_manifest(manifest_file, &manifest_options);
+    }
+
+    if (target_name == NULL) {
+        target_name = use_run_mode ? run_program : (log_file != NULL ? log_file : "manual");
+    }
+
     /* Handle --run mode */
     if (use_run_mode) {
         if (run_program == NULL) {
@@ -127,11 +315,31 @@ int main(int argc, char *argv[]) {
         }
         target_args[target_argc - 1] = NULL;
 
+        /* Optionally trace selected syscalls to recover the errno of the failure */
+        SyscallTraceConfig trace_config;
+        if (trace_errno && syscall_trace_config_parse(trace_syscalls, &trace_config) != 0) {
+            fprintf(stderr, "Error: Invalid syscall list: %s (unknown name or more than %d syscalls)\n",
+                    trace_syscalls != NULL ? trace_syscalls : "default", SYSCALL_TRACE_MAX);
+            free(target_args);
+            return EXIT_FAILURE;
+        }
+
+        /* Mark the end of the kernel log so only records produced during the run are read */
+        KernelLogCursor kernel_cursor;
+        kernel_log_open(&kernel_cursor);
+
         /* Run and monitor the program */
         ProcessResult proc_result;
-        int run_result = run_and_monitor(run_program, target_args, &proc_result);
+        int run_result = run_and_monitor_traced(run_program, target_args, trace_errno ? &trace_config : NULL,
+                                                &proc_result);
         free(target_args);
 
+        if (run_result == 0 && proc_result.ran_successfully &&
+            kernel_log_collect(&kernel_cursor, proc_result.pid, run_program, &kernel_events) == 0) {
+            kernel = &kernel_events;
+        }
+        kernel_log_close(&kernel_cursor);
+
         if (run_result != 0) {
             fprintf(stderr, "Failed to execute target program.\n");
             fprintf(stderr, "Reason: %s\n", strerror(errno));
@@ -145,47 +353,70 @@ int main(int argc, char *argv[]) {
         }
 
         /* Check termination status */
-        if (proc_result.exited_normally && proc_result.exit_code == 0) {
-            printf("Program exited normally. No failure detected.\n");
-            return EXIT_SUCCESS;
-        }
+        switch (evaluate_run_outcome(&proc_result, kernel)) {
+            case RUN_OUTCOME_SUCCESS:
+                printf("Program exited normally. No failure detected.\n");
+                record_history(history_dir, target_name, -1, 0, 0, HISTORY_NO_FAILURE, 0);
+                return EXIT_SUCCESS;
 
-        /* Check for exec failure (exit code 127 typically indicates command not found) */
-        if (proc_result.exited_normally && proc_result.exit_code == 127) {
-            fprintf(stderr, "Failed to execute target program.\n");
-            fprintf(stderr, "Reason: Command not found or exec failed\n");
-            return EXIT_FAILURE;
-        }
+            case RUN_OUTCOME_EXEC_FAILURE:
+                /* Exit code 127 typically indicates command not found */
+                fprintf(stderr, "Failed to execute target program.\n");
+                fprintf(stderr, "Reason: Command not found or exec failed\n");
+                return EXIT_FAILURE;
 
-        /* Program failed - analyze the failure */
-        if (proc_result.terminated_by_signal) {
-            signal_num = proc_result.signal_number;
-            printf("\nObserved Termination:\n");
-            printf("- Signal: %d", signal_num);
-            
-            /* Check if signal is known */
-            const SignalInfo *sig_info = analyze_signal(signal_num);
-            if (sig_info != NULL) {
-                printf(" (%s)\n", sig_info->name);
-            } else {
-                printf(" (Unknown)\n");
+            case RUN_OUTCOME_SIGNALED: {
+                /* Program failed - analyze the failure */
+                signal_num = proc_result.signal_number;
+                si_code = run_signal_code(&proc_result);
+                printf("\nObserved Termination:\n");
+                printf("- Signal: %d", signal_num);
+
+                /* The generated table names every signal from 1 to SIGRTMAX */
+                const SignalInfo *sig_info = analyze_signal(signal_num);
+                printf(" (%s)\n", sig_info != NULL ? sig_info->name : "unnamed");
+                print_signal_code(&proc_result);
+                printf("- Core dump: %s\n", proc_result.core_dumped ? "yes" : "no");
+                print_traced_syscall(&proc_result);
+                print_kernel_events(kernel);
+                printf("\n");
+                err_val = proc_result.syscall_errno;
+                break;
             }
-            printf("- Core dump: %s\n\n", proc_result.core_dumped ? "yes" : "no");
-        } else if (proc_result.exited_normally) {
-            /* Non-zero exit code */
-            printf("\nObserved Termination:\n");
-            printf("- Exit code: %d\n", proc_result.exit_code);
-            printf("- Signal: none\n\n");
-            printf("Failure detected, but no terminating signal was reported.\n");
-            printf("Classification: Unknown Failure\n");
-            return EXIT_SUCCESS;
-        } else {
-            /* Unknown termination state */
-            printf("\nObserved Termination:\n");
-            printf("- Termination state: unknown\n\n");
-            printf("Failure detected, but no terminating signal was reported.\n");
-            printf("Classification: Unknown Failure\n");
-            return EXIT_SUCCESS;
+
+            case RUN_OUTCOME_EXIT_CLASSIFIED:
+                exit_code = proc_result.exit_code;
+                err_val = proc_result.syscall_errno;
+                printf("\nObserved Termination:\n");
+                printf("- Exit code: %d\n", proc_result.exit_code);
+                printf("- Signal: none\n");
+                print_traced_syscall(&proc_result);
+                print_kernel_events(kernel);
+                printf("\n");
+                break;
+
+            case RUN_OUTCOME_EXIT_FAILURE:
+                /* Non-zero exit code */
+                printf("\nObserved Termination:\n");
+                printf("- Exit code: %d\n", proc_result.exit_code);
+                printf("- Signal: none\n");
+                print_traced_syscall(&proc_result);
+                print_kernel_events(kernel);
+                printf("\n");
+                printf("Failure detected, but no terminating signal was reported.\n");
+                printf("Classification: Unknown Failure\n");
+                record_history(history_dir, target_name, -1, 0, proc_result.exit_code, HISTORY_NO_FAILURE, 0);
+                return EXIT_SUCCESS;
+
+            case RUN_OUTCOME_UNKNOWN_STATE:
+            default:
+                /* Unknown termination state */
+                printf("\nObserved Termination:\n");
+                printf("- Termination state: unknown\n\n");
+                printf("Failure detected, but no terminating signal was reported.\n");
+                printf("Classification: Unknown Failure\n");
+                record_history(history_dir, target_name, -1, 0, -1, HISTORY_NO_FAILURE, 0);
+                return EXIT_SUCCESS;
         }
     }
 
@@ -196,26 +427,31 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
 
-    /* Handle unknown signals in run mode */
-    if (use_run_mode && signal_num != -1) {
-        const SignalInfo *sig_info = analyze_signal(signal_num);
-        if (sig_info == NULL) {
-            /* Unknown signal */
-            printf("Unknown signal encountered (signal %d)\n\n", signal_num);
-            printf("=== Failure Analysis Report ===\n\n");
-            printf("Failure Type: Unknown Failure\n");
-            printf("Root Cause:   Signal %d is not in the supported signal set\n", signal_num);
-            printf("\nDebug Steps:\n");
-            printf("This failure does not match known classifications.\n");
-            printf("Review signal %d documentation and investigate manually.\n", signal_num);
-            printf("================================\n\n");
-            return EXIT_SUCCESS;
+    /* Compile the log pattern dictionary once: built-in keywords plus any user patterns */
+    PatternDict dict;
+    pattern_dict_init(&dict);
+    if (log_file != NULL) {
+        if (pattern_dict_add_defaults(&dict) != 0) {
+            fprintf(stderr, "Error: Memory allocation failed\n");
+            pattern_dict_free(&dict);
+            return EXIT_FAILURE;
+        }
+        if (dict_file != NULL && pattern_dict_load_file(&dict, dict_file) != 0) {
+            fprintf(stderr, "Error: Failed to load pattern dictionary: %s\n", dict_file);
+            pattern_dict_free(&dict);
+            return EXIT_FAILURE;
+        }
+        if (pattern_dict_compile(&dict) != 0) {
+            fprintf(stderr, "Error: Failed to compile pattern dictionary\n");
+            pattern_dict_free(&dict);
+            return EXIT_FAILURE;
         }
     }
 
     /* Initialize modules and analyze failure */
     FailureReport report;
-    int result = evaluate_failure(signal_num, err_val, log_file, &report);
+    int result = evaluate_failure(signal_num, si_code, err_val, log_file, &dict, kernel, &report);
+    pattern_dict_free(&dict);
 
     if (result != 0) {
         fprintf(stderr, "Error: Failed to evaluate failure\n");
@@ -224,11 +460,12 @@ int main(int argc, char *argv[]) {
 
     /* Print structured output */
     printf("\n=== Failure Analysis Report ===\n\n");
-    printf("Failure Type: %s\n", failure_type_to_string(report.failure_type));
+    printf("Failure Type: %s\n", failure_type_name(report.failure_type));
     printf("Root Cause:   %s\n", report.root_cause);
     printf("\nDebug Steps:\n%s\n", report.debug_steps);
     printf("================================\n\n");
 
+    record_history(history_dir, target_name, signal_num, err_val, exit_code, report.failure_type, report.rule_id);
     return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,687 @@
+#define _GNU_SOURCE
+#include "manifest_runner.h"
+#include "failure_rules.h"
+#include "process_runner.h"
+#include "kernel_log.h"
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MANIFEST_MAX_ARGS 64
+
+/* Result labels besides the failure types */
+static const char *LABEL_SUCCESS = "SUCCESS";
+static const char *LABEL_FAILURE = "FAILURE";
+static const char *LABEL_EXEC_FAILURE = "EXEC_FAILURE";
+static const char *LABEL_UNKNOWN = "UNKNOWN";
+static const char *LABEL_TIMEOUT = "TIMEOUT";
+static const char *LABEL_ERROR = "ERROR";
+
+static const char *const failure_type_labels[] = {
+    [FAILURE_MEMORY_CORRUPTION] = "MEMORY_CORRUPTION",
+    [FAILURE_INVALID_STATE] = "INVALID_STATE",
+    [FAILURE_RESOURCE_EXHAUSTION] = "RESOURCE_EXHAUSTION",
+    [FAILURE_TIMING_RACE] = "TIMING_RACE",
+    [FAILURE_EXTERNAL_TERMINATION] = "EXTERNAL_TERMINATION"
+};
+
+typedef struct {
+    char *line_buffer;              /* Tokenized copy of the manifest line; tokens point into it */
+    char *command;                  /* Resolved program path (owned) */
+    char *argv[MANIFEST_MAX_ARGS + 1];
+    const char *name;
+    const char *expected;
+    double timeout;
+    int trace_errno;
+    SyscallTraceConfig trace_config;
+    int line;
+} ManifestEntry;
+
+/* Structured result, written by the worker process to the supervisor in one write() */
+typedef struct {
+    char label[32];                 /* Observed result label */
+    int rule_id;
+    int signal_num;                 /* -1 if none */
+    int exit_code;                  /* -1 if none */
+    int err_val;
+    char detail[192];               /* Root cause, or why the test could not run */
+} ManifestResult;
+
+typedef struct {
+    ManifestResult result;
+    size_t received;                /* Bytes of result received so far */
+    double latency;                 /* Seconds from launch to result */
+    int passed;
+} ManifestOutcome;
+
+typedef struct {
+    pid_t pid;
+    int fd;
+    size_t entry;
+    double start;
+    double deadline;
+} Worker;
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int is_known_label(const char *label) {
+    const char *labels[] = {LABEL_SUCCESS, LABEL_FAILURE, LABEL_EXEC_FAILURE, LABEL_UNKNOWN, LABEL_TIMEOUT};
+    for (size_t i = 0; i < sizeof(labels) / sizeof(labels[0]); i++) {
+        if (strcmp(label, labels[i]) == 0) {
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < sizeof(failure_type_labels) / sizeof(failure_type_labels[0]); i++) {
+        if (strcmp(label, failure_type_labels[i]) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Splits a line in place on whitespace; double-quoted spans may contain whitespace.
+ * Returns 0 on success, -1 if a quote is left unterminated.
+ */
+static int tokenize(char *line, char **tokens, size_t max_tokens, size_t *token_count) {
+    size_t count = 0;
+    char *p = line;
+
+    while (count < max_tokens) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+
+        /* Copy the word onto itself, dropping the quote characters */
+        char *out = p;
+        int quoted = 0;
+        tokens[count++] = out;
+        while (*p != '\0' && (quoted || (*p != ' ' && *p != '\t' && *p != '\r' && *p != '\n'))) {
+            if (*p == '"') {
+                quoted = !quoted;
+                p++;
+            } else {
+                *out++ = *p++;
+            }
+        }
+        if (quoted) {
+            return -1;
+        }
+        if (*p != '\0') {
+            p++;
+        }
+        *out = '\0';
+    }
+    *token_count = count;
+    return 0;
+}
+
+static void free_entries(ManifestEntry *entries, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(entries[i].line_buffer);
+        free(entries[i].command);
+    }
+    free(entries);
+}
+
+/* Parses one non-empty manifest line into an entry */
+static int parse_entry(char *line, int line_number, const char *base_dir, double default_timeout,
+                       ManifestEntry *entry) {
+    char *tokens[MANIFEST_MAX_ARGS + 8];
+    size_t count;
+
+    memset(entry, 0, sizeof(*entry));
+    entry->line = line_number;
+    entry->timeout = default_timeout;
+
+    if (tokenize(line, tokens, sizeof(tokens) / sizeof(tokens[0]), &count) != 0) {
+        fprintf(stderr, "Error: manifest line %d: unterminated quote\n", line_number);
+        return -1;
+    }
+    if (count < 2) {
+        fprintf(stderr, "Error: manifest line %d: expected \"<expected> <command> [args...]\"\n", line_number);
+        return -1;
+    }
+    entry->expected = tokens[0];
+    if (!is_known_label(entry->expected)) {
+        fprintf(stderr, "Error: manifest line %d: unknown expected result: %s\n", line_number, entry->expected);
+        return -1;
+    }
+
+    size_t i = 1;
+    for (; i < count; i++) {
+        if (strncmp(tokens[i], "name=", 5) == 0) {
+            entry->name = tokens[i] + 5;
+        } else if (strncmp(tokens[i], "timeout=", 8) == 0) {
+            char *end;
+            entry->timeout = strtod(tokens[i] + 8, &end);
+            if (end == tokens[i] + 8 || *end != '\0' || entry->timeout <= 0) {
+                fprintf(stderr, "Error: manifest line %d: invalid timeout: %s\n", line_number, tokens[i] + 8);
+                return -1;
+            }
+        } else if (strcmp(tokens[i], "trace-errno") == 0 || strncmp(tokens[i], "trace-errno=", 12) == 0) {
+            const char *list = tokens[i][11] == '=' ? tokens[i] + 12 : NULL;
+            entry->trace_errno = 1;
+            if (syscall_trace_config_parse(list, &entry->trace_config) != 0) {
+                fprintf(stderr, "Error: manifest line %d: invalid syscall list: %s\n", line_number, tokens[i]);
+                return -1;
+            }
+        } else {
+            break;
+        }
+    }
+
+    if (i >= count) {
+        fprintf(stderr, "Error: manifest line %d: missing command\n", line_number);
+        return -1;
+    }
+    if (count - i > MANIFEST_MAX_ARGS || count == sizeof(tokens) / sizeof(tokens[0])) {
+        fprintf(stderr, "Error: manifest line %d: more than %d arguments\n", line_number, MANIFEST_MAX_ARGS);
+        return -1;
+    }
+
+    /* Relative paths are relative to the manifest; bare names are looked up in PATH */
+    const char *program = tokens[i];
+    if (program[0] != '/' && strchr(program, '/') != NULL) {
+        if (asprintf(&entry->command, "%s/%s", base_dir, program) < 0) {
+            entry->command = NULL;
+            return -1;
+        }
+    } else {
+        entry->command = strdup(program);
+        if (entry->command == NULL) {
+            return -1;
+        }
+    }
+
+    entry->argv[0] = entry->command;
+    for (size_t a = 1; i + a < count; a++) {
+        entry->argv[a] = tokens[i + a];
+    }
+    entry->argv[count - i] = NULL;
+
+    if (entry->name == NULL) {
+        const char *base = strrchr(program, '/');
+        entry->name = base != NULL ? base + 1 : program;
+    }
+    return 0;
+}
+
+static int load_manifest(const char *manifest_file, double default_timeout, ManifestEntry **entries_out,
+                         size_t *count_out) {
+    FILE *fp = fopen(manifest_file, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "Error: Cannot open manifest %s: %s\n", manifest_file, strerror(errno));
+        return -1;
+    }
+
+    char *base_dir = strdup(manifest_file);
+    if (base_dir == NULL) {
+        fclose(fp);
+        return -1;
+    }
+    char *slash = strrchr(base_dir, '/');
+    if (slash == NULL) {
+        strcpy(base_dir, ".");
+    } else if (slash == base_dir) {
+        slash[1] = '\0';
+    } else {
+        *slash = '\0';
+    }
+
+    ManifestEntry *entries = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    char *line = NULL;
+    size_t line_size = 0;
+    int line_number = 0;
+    int status = 0;
+
+    while (getline(&line, &line_size, fp) >= 0) {
+        line_number++;
+        const char *p = line + strspn(line, " \t\r\n");
+        if (*p == '\0' || *p == '#') {
+            continue;
+        }
+
+        if (count == capacity) {
+            size_t new_capacity = capacity == 0 ? 64 : capacity * 2;
+            ManifestEntry *grown = realloc(entries, new_capacity * sizeof(*entries));
+            if (grown == NULL) {
+                status = -1;
+                break;
+            }
+            entries = grown;
+            capacity = new_capacity;
+        }
+
+        char *copy = strdup(line);
+        if (copy == NULL) {
+            status = -1;
+            break;
+        }
+        if (parse_entry(copy, line_number, base_dir, default_timeout, &entries[count]) != 0) {
+            free(copy);
+            free(entries[count].command);
+            status = -1;
+            break;
+        }
+        entries[count++].line_buffer = copy;
+    }
+
+    free(line);
+    free(base_dir);
+    fclose(fp);
+
+    if (status != 0) {
+        free_entries(entries, count);
+        return -1;
+    }
+    *entries_out = entries;
+    *count_out = count;
+    return 0;
+}
+
+/* Runs one test and classifies it; executed inside the worker process */
+static void run_entry(const ManifestEntry *entry, ManifestResult *result) {
+    memset(result, 0, sizeof(*result));
+    result->signal_num = -1;
+    result->exit_code = -1;
+
+    KernelLogCursor kernel_cursor;
+    kernel_log_open(&kernel_cursor);
+
+    ProcessResult proc_result;
+    if (run_and_monitor_traced(entry->command, (char **)entry->argv, entry->trace_errno ? &entry->trace_config : NULL,
+                               &proc_result) != 0 || !proc_result.ran_successfully) {
+        snprintf(result->label, sizeof(result->label), "%s", LABEL_ERROR);
+        snprintf(result->detail, sizeof(result->detail), "Failed to launch: %s", strerror(errno));
+        kernel_log_close(&kernel_cursor);
+        return;
+    }
+
+    KernelEvents kernel_events;
+    const KernelEvents *kernel = NULL;
+    if (kernel_log_collect(&kernel_cursor, proc_result.pid, entry->command, &kernel_events) == 0) {
+        kernel = &kernel_events;
+    }
+    kernel_log_close(&kernel_cursor);
+
+    if (proc_result.terminated_by_signal) {
+        result->signal_num = proc_result.signal_number;
+    } else if (proc_result.exited_normally) {
+        result->exit_code = proc_result.exit_code;
+    }
+    result->err_val = proc_result.syscall_errno;
+
+    const char *label = LABEL_UNKNOWN;
+    FailureReport report;
+    switch (evaluate_run_outcome(&proc_result, kernel)) {
+        case RUN_OUTCOME_SUCCESS:
+            label = LABEL_SUCCESS;
+            break;
+        case RUN_OUTCOME_EXEC_FAILURE:
+            label = LABEL_EXEC_FAILURE;
+            snprintf(result->detail, sizeof(result->detail), "Command not found or exec failed");
+            break;
+        case RUN_OUTCOME_EXIT_FAILURE:
+            label = LABEL_FAILURE;
+            snprintf(result->detail, sizeof(result->detail), "Exit code %d, no terminating signal", proc_result.exit_code);
+            break;
+        case RUN_OUTCOME_SIGNALED:
+        case RUN_OUTCOME_EXIT_CLASSIFIED:
+            if (evaluate_failure(result->signal_num, run_signal_code(&proc_result), result->err_val, NULL, NULL,
+                                 kernel, &report) == 0) {
+                label = failure_type_labels[report.failure_type];
+                result->rule_id = report.rule_id;
+                snprintf(result->detail, sizeof(result->detail), "%s", report.root_cause);
+            }
+            break;
+        case RUN_OUTCOME_UNKNOWN_STATE:
+        default:
+            snprintf(result->detail, sizeof(result->detail), "Termination not covered by any classification");
+            break;
+    }
+    snprintf(result->label, sizeof(result->label), "%s", label);
+}
+
+/* Forks a worker for one entry; the worker leads its own process group */
+static int start_worker(const ManifestEntry *entry, size_t index, Worker *worker) {
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+        return -1;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+
+    if (pid == 0) {
+        setpgid(0, 0);
+        close(fds[0]);
+
+        /* Keep test output off the runner's terminal */
+        int null_fd = open("/dev/null", O_RDWR);
+        if (null_fd >= 0) {
+            dup2(null_fd, STDIN_FILENO);
+            dup2(null_fd, STDOUT_FILENO);
+            dup2(null_fd, STDERR_FILENO);
+            if (null_fd > STDERR_FILENO) {
+                close(null_fd);
+            }
+        }
+
+        ManifestResult result;
+        run_entry(entry, &result);
+        ssize_t written = write(fds[1], &result, sizeof(result));
+        _exit(written == (ssize_t)sizeof(result) ? 0 : 1);
+    }
+
+    /* Set the group from both sides so a timeout kill cannot race the child */
+    setpgid(pid, pid);
+    close(fds[1]);
+
+    worker->pid = pid;
+    worker->fd = fds[0];
+    worker->entry = index;
+    worker->start = monotonic_seconds();
+    worker->deadline = worker->start + entry->timeout;
+    return 0;
+}
+
+static void finish_worker(Worker *worker, const ManifestEntry *entries, ManifestOutcome *outcomes, int timed_out) {
+    const ManifestEntry *entry = &entries[worker->entry];
+    ManifestOutcome *outcome = &outcomes[worker->entry];
+    ManifestResult *result = &outcome->result;
+
+    if (timed_out) {
+        kill(-worker->pid, SIGKILL);
+        kill(worker->pid, SIGKILL);
+    }
+    close(worker->fd);
+    while (waitpid(worker->pid, NULL, 0) < 0 && errno == EINTR) {
+    }
+    outcome->latency = monotonic_seconds() - worker->start;
+
+    if (timed_out) {
+        memset(result, 0, sizeof(*result));
+        result->signal_num = -1;
+        result->exit_code = -1;
+        snprintf(result->label, sizeof(result->label), "%s", LABEL_TIMEOUT);
+        snprintf(result->detail, sizeof(result->detail), "No result after %.1f s", entry->timeout);
+    } else if (outcome->received != sizeof(*result)) {
+        memset(result, 0, sizeof(*result));
+        snprintf(result->label, sizeof(result->label), "%s", LABEL_ERROR);
+        snprintf(result->detail, sizeof(result->detail), "Worker exited without a result");
+    }
+    result->label[sizeof(result->label) - 1] = '\0';
+    result->detail[sizeof(result->detail) - 1] = '\0';
+
+    outcome->passed = strcmp(result->label, entry->expected) == 0;
+    if (outcome->passed) {
+        printf("[PASS] %s: %s (%.1f ms)\n", entry->name, result->label, outcome->latency * 1000.0);
+    } else {
+        printf("[FAIL] %s: expected %s, got %s - %s (%.1f ms)\n", entry->name, entry->expected, result->label,
+               result->detail, outcome->latency * 1000.0);
+    }
+    fflush(stdout);
+    worker->pid = 0;
+}
+
+static void write_xml_escaped(FILE *fp, const char *text) {
+    for (const unsigned char *p = (const unsigned char *)text; *p != '\0'; p++) {
+        switch (*p) {
+            case '&':
+                fputs("&amp;", fp);
+                break;
+            case '<':
+                fputs("&lt;", fp);
+                break;
+            case '>':
+                fputs("&gt;", fp);
+                break;
+            case '"':
+                fputs("&quot;", fp);
+                break;
+            case '\'':
+                fputs("&apos;", fp);
+                break;
+            default:
+                /* XML 1.0 forbids most control characters */
+                fputc(*p < 0x20 && *p != '\t' && *p != '\n' ? '?' : *p, fp);
+                break;
+        }
+    }
+}
+
+static int write_junit(const char *junit_file, const char *manifest_file, const ManifestEntry *entries,
+                       const ManifestOutcome *outcomes, size_t count, size_t failures, size_t errors,
+                       double elapsed) {
+    FILE *fp = fopen(junit_file, "w");
+    if (fp == NULL) {
+        fprintf(stderr, "Error: Cannot write JUnit report %s: %s\n", junit_file, strerror(errno));
+        return -1;
+    }
+
+    fprintf(fp, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    fprintf(fp, "<testsuites tests=\"%zu\" failures=\"%zu\" errors=\"%zu\" time=\"%.3f\">\n", count, failures,
+            errors, elapsed);
+    fprintf(fp, "  <testsuite name=\"");
+    write_xml_escaped(fp, manifest_file);
+    fprintf(fp, "\" tests=\"%zu\" failures=\"%zu\" errors=\"%zu\" skipped=\"0\" time=\"%.3f\">\n", count, failures,
+            errors, elapsed);
+
+    for (size_t i = 0; i < count; i++) {
+        const ManifestEntry *entry = &entries[i];
+        const ManifestResult *result = &outcomes[i].result;
+
+        fprintf(fp, "    <testcase classname=\"auto_analyze.manifest\" name=\"");
+        write_xml_escaped(fp, entry->name);
+        fprintf(fp, "\" time=\"%.6f\">\n", outcomes[i].latency);
+
+        if (!outcomes[i].passed) {
+            const char *element = strcmp(result->label, LABEL_ERROR) == 0 ? "error" : "failure";
+            fprintf(fp, "      <%s type=\"%s\" message=\"expected ", element, result->label);
+            write_xml_escaped(fp, entry->expected);
+            fprintf(fp, ", got %s\">", result->label);
+            write_xml_escaped(fp, result->detail);
+            fprintf(fp, "</%s>\n", element);
+        }
+
+        fprintf(fp, "      <system-out>line %d: %s", entry->line, result->label);
+        if (result->rule_id != 0) {
+            fprintf(fp, " (rule %d)", result->rule_id);
+        }
+        if (result->signal_num != -1) {
+            fprintf(fp, ", signal %d", result->signal_num);
+        }
+        if (result->exit_code != -1) {
+            fprintf(fp, ", exit code %d", result->exit_code);
+        }
+        if (result->err_val != 0) {
+            fprintf(fp, ", errno %d", result->err_val);
+        }
+        if (result->detail[0] != '\0') {
+            fprintf(fp, ": ");
+            write_xml_escaped(fp, result->detail);
+        }
+        fprintf(fp, "</system-out>\n");
+        fprintf(fp, "    </testcase>\n");
+    }
+
+    fprintf(fp, "  </testsuite>\n</testsuites>\n");
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "Error: Cannot write JUnit report %s: %s\n", junit_file, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+int run_manifest(const char *manifest_file, const ManifestOptions *options) {
+    double default_timeout = options->timeout > 0 ? options->timeout : MANIFEST_DEFAULT_TIMEOUT;
+    int max_workers = options->workers;
+    if (max_workers <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        max_workers = (cpus > 0 ? (int)cpus : 1) * MANIFEST_WORKERS_PER_CPU;
+    }
+
+    ManifestEntry *entries;
+    size_t count;
+    if (load_manifest(manifest_file, default_timeout, &entries, &count) != 0) {
+        return EXIT_FAILURE;
+    }
+    if ((size_t)max_workers > count) {
+        max_workers = count > 0 ? (int)count : 1;
+    }
+
+    ManifestOutcome *outcomes = calloc(count > 0 ? count : 1, sizeof(*outcomes));
+    Worker *workers = calloc((size_t)max_workers, sizeof(*workers));
+    struct pollfd *fds = calloc((size_t)max_workers, sizeof(*fds));
+    int *fd_worker = calloc((size_t)max_workers, sizeof(*fd_worker));
+    if (outcomes == NULL || workers == NULL || fds == NULL || fd_worker == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        free(outcomes);
+        free(workers);
+        free(fds);
+        free(fd_worker);
+        free_entries(entries, count);
+        return EXIT_FAILURE;
+    }
+
+    printf("Running %zu tests from %s on %d workers\n", count, manifest_file, max_workers);
+    fflush(stdout);
+
+    double suite_start = monotonic_seconds();
+    size_t next = 0;
+    size_t done = 0;
+    int active = 0;
+
+    while (done < count) {
+        /* Keep the pool full */
+        for (int w = 0; w < max_workers && next < count; w++) {
+            if (workers[w].pid != 0) {
+                continue;
+            }
+            if (start_worker(&entries[next], next, &workers[w]) != 0) {
+                ManifestResult *result = &outcomes[next].result;
+                snprintf(result->label, sizeof(result->label), "%s", LABEL_ERROR);
+                snprintf(result->detail, sizeof(result->detail), "Cannot start worker: %s", strerror(errno));
+                result->signal_num = -1;
+                result->exit_code = -1;
+                printf("[FAIL] %s: %s\n", entries[next].name, result->detail);
+                done++;
+            } else {
+                active++;
+            }
+            next++;
+        }
+        if (active == 0) {
+            continue;
+        }
+
+        /* Wait for a result or the nearest deadline */
+        double now = monotonic_seconds();
+        double nearest = 0;
+        nfds_t nfds = 0;
+        for (int w = 0; w < max_workers; w++) {
+            if (workers[w].pid == 0) {
+                continue;
+            }
+            if (nfds == 0 || workers[w].deadline < nearest) {
+                nearest = workers[w].deadline;
+            }
+            fds[nfds].fd = workers[w].fd;
+            fds[nfds].events = POLLIN;
+            fds[nfds].revents = 0;
+            fd_worker[nfds++] = w;
+        }
+        int wait_ms = nearest > now ? (int)((nearest - now) * 1000.0) + 1 : 0;
+        if (poll(fds, nfds, wait_ms) < 0 && errno != EINTR) {
+            fprintf(stderr, "Error: poll failed: %s\n", strerror(errno));
+            for (int w = 0; w < max_workers; w++) {
+                if (workers[w].pid != 0) {
+                    finish_worker(&workers[w], entries, outcomes, 1);
+                }
+            }
+            break;
+        }
+
+        now = monotonic_seconds();
+        for (nfds_t i = 0; i < nfds; i++) {
+            Worker *worker = &workers[fd_worker[i]];
+            ManifestOutcome *outcome = &outcomes[worker->entry];
+            int finished = 0;
+
+            if (fds[i].revents != 0) {
+                char *buffer = (char *)&outcome->result;
+                ssize_t n = read(worker->fd, buffer + outcome->received, sizeof(outcome->result) - outcome->received);
+                if (n > 0) {
+                    outcome->received += (size_t)n;
+                }
+                finished = n == 0 || (n < 0 && errno != EINTR && errno != EAGAIN) ||
+                           outcome->received == sizeof(outcome->result);
+            }
+            if (finished) {
+                finish_worker(worker, entries, outcomes, 0);
+            } else if (now >= worker->deadline) {
+                finish_worker(worker, entries, outcomes, 1);
+            } else {
+                continue;
+            }
+            active--;
+            done++;
+        }
+    }
+    double elapsed = monotonic_seconds() - suite_start;
+
+    size_t passed = 0;
+    size_t errors = 0;
+    double slowest = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (outcomes[i].passed) {
+            passed++;
+        } else if (strcmp(outcomes[i].result.label, LABEL_ERROR) == 0) {
+            errors++;
+        }
+        if (outcomes[i].latency > slowest) {
+            slowest = outcomes[i].latency;
+        }
+    }
+    size_t failures = count - passed - errors;
+
+    printf("\n%zu tests, %zu passed, %zu failed, %zu errors in %.3f s (slowest test %.3f s)\n", count, passed,
+           failures, errors, elapsed, slowest);
+
+    int status = failures == 0 && errors == 0 && done == count ? EXIT_SUCCESS : EXIT_FAILURE;
+    if (options->junit_file != NULL &&
+        write_junit(options->junit_file, manifest_file, entries, outcomes, count, failures, errors, elapsed) != 0) {
+        status = EXIT_FAILURE;
+    }
+
+    free(outcomes);
+    free(workers);
+    free(fds);
+    free(fd_worker);
+    free_entries(entries, count);
+    return status;
+}
@@ -0,0 +1,431 @@
+#define _POSIX_C_SOURCE 200809L
+#include "pattern_dict.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+typedef struct {
+    const char *pattern;
+    PatternCategory category;
+} DefaultPattern;
+
+/* Built-in keyword set, equivalent to the original hard-coded strstr() scan */
+static const DefaultPattern default_patterns[] = {
+    {"segfault", PATTERN_CATEGORY_SEGFAULT},
+    {"segmentation", PATTERN_CATEGORY_SEGFAULT},
+    {"sigsegv", PATTERN_CATEGORY_SEGFAULT},
+    {"memory", PATTERN_CATEGORY_MEMORY},
+    {"malloc", PATTERN_CATEGORY_MEMORY},
+    {"free", PATTERN_CATEGORY_MEMORY},
+    {"leak", PATTERN_CATEGORY_MEMORY},
+    {"corruption", PATTERN_CATEGORY_MEMORY},
+    {"timeout", PATTERN_CATEGORY_TIMEOUT},
+    {"deadlock", PATTERN_CATEGORY_TIMEOUT},
+    {"hung", PATTERN_CATEGORY_TIMEOUT},
+    {"stuck", PATTERN_CATEGORY_TIMEOUT},
+    {"out of memory", PATTERN_CATEGORY_RESOURCE},
+    {"enomem", PATTERN_CATEGORY_RESOURCE},
+    {"resource", PATTERN_CATEGORY_RESOURCE},
+    {"exhausted", PATTERN_CATEGORY_RESOURCE}
+};
+
+static const size_t default_patterns_size = sizeof(default_patterns) / sizeof(default_patterns[0]);
+
+static const char *category_names[PATTERN_CATEGORY_COUNT] = {
+    "segfault",
+    "memory",
+    "timeout",
+    "resource"
+};
+
+static void release_automaton(PatternDict *dict) {
+    free(dict->transitions);
+    free(dict->scores);
+    free(dict->has_output);
+    dict->transitions = NULL;
+    dict->scores = NULL;
+    dict->has_output = NULL;
+    dict->state_count = 0;
+    dict->class_count = 0;
+    dict->compiled = 0;
+}
+
+void pattern_dict_init(PatternDict *dict) {
+    if (dict == NULL) {
+        return;
+    }
+    memset(dict, 0, sizeof(*dict));
+}
+
+void pattern_dict_free(PatternDict *dict) {
+    if (dict == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < dict->entry_count; i++) {
+        free(dict->entries[i].text);
+    }
+    free(dict->entries);
+    release_automaton(dict);
+    pattern_dict_init(dict);
+}
+
+int pattern_category_from_name(const char *name, PatternCategory *category) {
+    if (name == NULL || category == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < PATTERN_CATEGORY_COUNT; i++) {
+        const char *a = name;
+        const char *b = category_names[i];
+        while (*a && *b && tolower((unsigned char)*a) == *b) {
+            a++;
+            b++;
+        }
+        if (*a == '\0' && *b == '\0') {
+            *category = (PatternCategory)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int pattern_dict_add(PatternDict *dict, const char *pattern, PatternCategory category, double weight) {
+    if (dict == NULL || pattern == NULL || dict->compiled) {
+        return -1;
+    }
+    if ((int)category < 0 || category >= PATTERN_CATEGORY_COUNT) {
+        return -1;
+    }
+    /* NaN or infinite weights would poison the score comparison between categories */
+    if (!isfinite(weight) || weight <= 0.0) {
+        return -1;
+    }
+
+    size_t length = strlen(pattern);
+    if (length == 0 || strchr(pattern, '\n') != NULL) {
+        return -1;
+    }
+
+    if (dict->entry_count == dict->entry_capacity) {
+        size_t new_capacity = dict->entry_capacity ? dict->entry_capacity * 2 : 32;
+        PatternEntry *grown = realloc(dict->entries, new_capacity * sizeof(*grown));
+        if (grown == NULL) {
+            return -1;
+        }
+        dict->entries = grown;
+        dict->entry_capacity = new_capacity;
+    }
+
+    char *text = malloc(length + 1);
+    if (text == NULL) {
+        return -1;
+    }
+    for (size_t i = 0; i < length; i++) {
+        text[i] = (char)tolower((unsigned char)pattern[i]);
+    }
+    text[length] = '\0';
+
+    PatternEntry *entry = &dict->entries[dict->entry_count++];
+    entry->text = text;
+    entry->length = length;
+    entry->category = category;
+    entry->weight = weight;
+    return 0;
+}
+
+int pattern_dict_add_defaults(PatternDict *dict) {
+    for (size_t i = 0; i < default_patterns_size; i++) {
+        if (pattern_dict_add(dict, default_patterns[i].pattern, default_patterns[i].category, 1.0) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int pattern_dict_load_file(PatternDict *dict, const char *filename) {
+    if (dict == NULL || filename == NULL) {
+        return -1;
+    }
+
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    /* getline() so that long patterns are never split into a bogus second entry */
+    char *line = NULL;
+    size_t line_size = 0;
+    int result = 0;
+
+    while (getline(&line, &line_size, file) != -1) {
+        /* Strip trailing newline / carriage return */
+        size_t len = strcspn(line, "\r\n");
+        line[len] = '\0';
+
+        char *p = line;
+        while (isspace((unsigned char)*p)) {
+            p++;
+        }
+        if (*p == '\0' || *p == '#') {
+            continue;
+        }
+
+        /* Field 1: category name */
+        char *name = p;
+        while (*p && !isspace((unsigned char)*p)) {
+            p++;
+        }
+        if (*p == '\0') {
+            result = -1;
+            break;
+        }
+        *p++ = '\0';
+
+        PatternCategory category;
+        if (pattern_category_from_name(name, &category) != 0) {
+            result = -1;
+            break;
+        }
+
+        /* Field 2: weight */
+        char *end;
+        double weight = strtod(p, &end);
+        if (end == p || !isspace((unsigned char)*end)) {
+            result = -1;
+            break;
+        }
+
+        /* Field 3: pattern text to end of line */
+        p = end;
+        while (isspace((unsigned char)*p)) {
+            p++;
+        }
+        if (pattern_dict_add(dict, p, category, weight) != 0) {
+            result = -1;
+            break;
+        }
+    }
+
+    free(line);
+    fclose(file);
+    return result;
+}
+
+static int grow_states(PatternDict *dict, size_t *capacity) {
+    size_t new_capacity = *capacity * 2;
+    int32_t *transitions = realloc(dict->transitions, new_capacity * dict->class_count * sizeof(*transitions));
+    if (transitions == NULL) {
+        return -1;
+    }
+    dict->transitions = transitions;
+
+    double *scores = realloc(dict->scores, new_capacity * PATTERN_CATEGORY_COUNT * sizeof(*scores));
+    if (scores == NULL) {
+        return -1;
+    }
+    dict->scores = scores;
+
+    uint8_t *has_output = realloc(dict->has_output, new_capacity * sizeof(*has_output));
+    if (has_output == NULL) {
+        return -1;
+    }
+    dict->has_output = has_output;
+
+    memset(dict->transitions + *capacity * dict->class_count, 0,
+           (new_capacity - *capacity) * dict->class_count * sizeof(*transitions));
+    memset(dict->scores + *capacity * PATTERN_CATEGORY_COUNT, 0,
+           (new_capacity - *capacity) * PATTERN_CATEGORY_COUNT * sizeof(*scores));
+    memset(dict->has_output + *capacity, 0, (new_capacity - *capacity) * sizeof(*has_output));
+    *capacity = new_capacity;
+    return 0;
+}
+
+int pattern_dict_compile(PatternDict *dict) {
+    if (dict == NULL) {
+        return -1;
+    }
+    release_automaton(dict);
+
+    /* Build byte classes: every distinct (lowercased) pattern byte gets its own
+     * class, all remaining bytes share class 0. Upper-case letters fold onto
+     * their lower-case class so the scan is case-insensitive for free. */
+    memset(dict->class_map, 0, sizeof(dict->class_map));
+    dict->class_count = 1;
+    for (size_t i = 0; i < dict->entry_count; i++) {
+        for (size_t j = 0; j < dict->entries[i].length; j++) {
+            unsigned char c = (unsigned char)dict->entries[i].text[j];
+            if (dict->class_map[c] == 0) {
+                if (dict->class_count > UINT8_MAX) {
+                    return -1;
+                }
+                dict->class_map[c] = (uint8_t)dict->class_count++;
+            }
+        }
+    }
+    for (int c = 0; c < 256; c++) {
+        int lower = tolower(c);
+        if (lower != c) {
+            dict->class_map[c] = dict->class_map[lower];
+        }
+    }
+
+    /* Phase 1: trie. Transition 0 means "no child" (the root is never a child). */
+    size_t capacity = 64;
+    size_t classes = dict->class_count;
+    dict->transitions = calloc(capacity * classes, sizeof(*dict->transitions));
+    dict->scores = calloc(capacity * PATTERN_CATEGORY_COUNT, sizeof(*dict->scores));
+    dict->has_output = calloc(capacity, sizeof(*dict->has_output));
+    if (dict->transitions == NULL || dict->scores == NULL || dict->has_output == NULL) {
+        release_automaton(dict);
+        return -1;
+    }
+    dict->state_count = 1;
+
+    for (size_t i = 0; i < dict->entry_count; i++) {
+        const PatternEntry *entry = &dict->entries[i];
+        size_t state = 0;
+        for (size_t j = 0; j < entry->length; j++) {
+            size_t cls = dict->class_map[(unsigned char)entry->text[j]];
+            int32_t next = dict->transitions[state * classes + cls];
+            if (next == 0) {
+                if (dict->state_count == capacity && grow_states(dict, &capacity) != 0) {
+                    release_automaton(dict);
+                    return -1;
+                }
+                if (dict->state_count > (size_t)(INT32_MAX >> 1)) {
+                    release_automaton(dict);
+                    return -1;
+                }
+                next = (int32_t)dict->state_count++;
+                dict->transitions[state * classes + cls] = next;
+            }
+            state = (size_t)next;
+        }
+        dict->scores[state * PATTERN_CATEGORY_COUNT + entry->category] += entry->weight;
+        dict->has_output[state] = 1;
+    }
+
+    /* Phase 2: breadth-first failure links, filling missing transitions so the
+     * table becomes a complete DFA and merging suffix outputs into each state. */
+    int32_t *fail = calloc(dict->state_count, sizeof(*fail));
+    int32_t *queue = malloc(dict->state_count * sizeof(*queue));
+    if (fail == NULL || queue == NULL) {
+        free(fail);
+        free(queue);
+        release_automaton(dict);
+        return -1;
+    }
+
+    size_t head = 0;
+    size_t tail = 0;
+    for (size_t cls = 0; cls < classes; cls++) {
+        int32_t child = dict->transitions[cls];
+        if (child != 0) {
+            fail[child] = 0;
+            queue[tail++] = child;
+        }
+    }
+
+    while (head < tail) {
+        size_t state = (size_t)queue[head++];
+        size_t fallback = (size_t)fail[state];
+        for (size_t cls = 0; cls < classes; cls++) {
+            int32_t child = dict->transitions[state * classes + cls];
+            int32_t via_fail = dict->transitions[fallback * classes + cls];
+            if (child != 0) {
+                fail[child] = via_fail;
+                /* A pattern ending here hides the shorter patterns of other
+                 * categories it ends with ("memory" in "out of memory"), so
+                 * one phrase never scores for two categories. has_output is
+                 * still the child's own flag, its suffixes are merged below. */
+                double *child_scores = &dict->scores[(size_t)child * PATTERN_CATEGORY_COUNT];
+                for (int k = 0; k < PATTERN_CATEGORY_COUNT; k++) {
+                    if (!dict->has_output[child] || child_scores[k] > 0.0) {
+                        child_scores[k] += dict->scores[(size_t)via_fail * PATTERN_CATEGORY_COUNT + k];
+                    }
+                }
+                dict->has_output[child] |= dict->has_output[via_fail];
+                queue[tail++] = child;
+            } else {
+                dict->transitions[state * classes + cls] = via_fail;
+            }
+        }
+    }
+
+    free(fail);
+
+    /* Phase 3: renumber states in breadth-first order so the shallow states a
+     * scan spends most of its time in share cache lines, and fold the output
+     * flag into the low bit of each transition so non-matching bytes touch
+     * only the transition table. */
+    size_t state_count = dict->state_count;
+    int32_t *rank = malloc(state_count * sizeof(*rank));
+    int32_t *transitions = malloc(state_count * classes * sizeof(*transitions));
+    double *scores = malloc(state_count * PATTERN_CATEGORY_COUNT * sizeof(*scores));
+    uint8_t *has_output = malloc(state_count * sizeof(*has_output));
+    if (rank == NULL || transitions == NULL || scores == NULL || has_output == NULL) {
+        free(queue);
+        free(rank);
+        free(transitions);
+        free(scores);
+        free(has_output);
+        release_automaton(dict);
+        return -1;
+    }
+
+    rank[0] = 0;
+    for (size_t i = 0; i < tail; i++) {
+        rank[queue[i]] = (int32_t)(i + 1);
+    }
+
+    for (size_t old_state = 0; old_state < state_count; old_state++) {
+        size_t new_state = (size_t)rank[old_state];
+        for (size_t cls = 0; cls < classes; cls++) {
+            int32_t next = dict->transitions[old_state * classes + cls];
+            transitions[new_state * classes + cls] =
+                (int32_t)(((uint32_t)rank[next] << 1) | dict->has_output[next]);
+        }
+        memcpy(&scores[new_state * PATTERN_CATEGORY_COUNT],
+               &dict->scores[old_state * PATTERN_CATEGORY_COUNT],
+               PATTERN_CATEGORY_COUNT * sizeof(*scores));
+        has_output[new_state] = dict->has_output[old_state];
+    }
+
+    free(queue);
+    free(rank);
+    free(dict->transitions);
+    free(dict->scores);
+    free(dict->has_output);
+    dict->transitions = transitions;
+    dict->scores = scores;
+    dict->has_output = has_output;
+    dict->compiled = 1;
+    return 0;
+}
+
+void pattern_dict_scan(const PatternDict *dict, const char *text, size_t length, int32_t *state, double *scores) {
+    if (dict == NULL || !dict->compiled || text == NULL || state == NULL || scores == NULL) {
+        return;
+    }
+
+    const int32_t *transitions = dict->transitions;
+    const uint8_t *class_map = dict->class_map;
+    const size_t classes = dict->class_count;
+    size_t current = (size_t)*state;
+
+    /* Newlines fall into class 0, which always leads back to the root, so
+     * matches never span lines without a per-byte check. */
+    for (size_t i = 0; i < length; i++) {
+        uint32_t next = (uint32_t)transitions[current * classes + class_map[(unsigned char)text[i]]];
+        current = next >> 1;
+        if (next & 1u) {
+            const double *out = &dict->scores[current * PATTERN_CATEGORY_COUNT];
+            for (int k = 0; k < PATTERN_CATEGORY_COUNT; k++) {
+                scores[k] += out[k];
+            }
+        }
+    }
+
+    *state = (int32_t)current;
+}
@@ -1,64 +1,546 @@
 #define _GNU_SOURCE
 #include "process_runner.h"
+#include "sys_tables.h"
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/ptrace.h>
+#include <sys/prctl.h>
+#include <linux/audit.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
 
-int run_and_monitor(char *program, char **args, ProcessResult *result) {
+/* Architecture the seccomp filter matches; other ABIs are never traced */
+#if defined(__x86_64__) && !defined(__ILP32__)
+#define TRACE_AUDIT_ARCH AUDIT_ARCH_X86_64
+#elif defined(__i386__)
+#define TRACE_AUDIT_ARCH AUDIT_ARCH_I386
+#elif defined(__aarch64__)
+#define TRACE_AUDIT_ARCH AUDIT_ARCH_AARCH64
+#elif defined(__riscv) && __riscv_xlen == 64
+#define TRACE_AUDIT_ARCH AUDIT_ARCH_RISCV64
+#endif
+
+/* Memory and output syscalls whose errno maps to a failure rule */
+static const char *const default_trace_syscalls[] = {
+    "mmap", "mremap", "brk", "mprotect", "write", "writev"
+};
+
+#define TRACE_FILTER_MAX (2 * SYSCALL_TRACE_MAX + 5)
+#define TRACE_MAX_PENDING 256
+
+/* Kernel-internal restart codes: the syscall is restarted or fails later with EINTR */
+#define KERNEL_ERESTARTSYS 512
+#define KERNEL_ERESTART_RESTARTBLOCK 516
+
+/* Syscall number of a thread between its seccomp stop and syscall-exit stop */
+typedef struct {
+    pid_t tid;
+    int nr;
+} PendingSyscall;
+
+/* Threads and processes attached to the tracer; only these are ever waited for */
+typedef struct {
+    pid_t *tids;
+    size_t count;
+    size_t capacity;
+} TracedTasks;
+
+static void fill_result(int status, ProcessResult *result) {
+    /* Mark that the program ran successfully (we got past fork/exec) */
+    result->ran_successfully = 1;
+
+    /* Analyze termination status */
+    if (WIFEXITED(status)) {
+        /* Program called exit() */
+        result->exited_normally = 1;
+        result->exit_code = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        /* Program was terminated by a signal */
+        result->terminated_by_signal = 1;
+        result->signal_number = WTERMSIG(status);
+        result->core_dumped = WCOREDUMP(status) ? 1 : 0;
+    } else {
+        /* Unknown termination state (should not happen normally) */
+        /* Leave flags as 0 to indicate unknown state */
+    }
+}
+
+const char *syscall_name(int nr) {
+    if (nr < 0 || (size_t)nr >= sys_syscall_names_size) {
+        return NULL;
+    }
+    return sys_syscall_names[nr];
+}
+
+const SiCodeInfo *run_signal_code(const ProcessResult *result) {
+    if (result == NULL || !result->terminated_by_signal || !result->has_signal_info) {
+        return NULL;
+    }
+    int code = result->signal_code;
+    if (code <= 0 && (result->signal_sender == 0 || result->signal_sender == result->pid)) {
+        return NULL;
+    }
+    return analyze_si_code(result->signal_number, code);
+}
+
+RunOutcome evaluate_run_outcome(const ProcessResult *result, const KernelEvents *kernel) {
+    /* Programs routinely survive failed syscalls (EAGAIN, fallbacks), so exit status 0 wins */
+    if (result->exited_normally && result->exit_code == 0) {
+        return RUN_OUTCOME_SUCCESS;
+    }
+    if (result->exited_normally && result->exit_code == 127) {
+        return RUN_OUTCOME_EXEC_FAILURE;
+    }
+    if (result->terminated_by_signal) {
+        return RUN_OUTCOME_SIGNALED;
+    }
+    if (result->exited_normally) {
+        /* Exit code alone says little, but a traced syscall failed or the kernel reported the task */
+        if (result->syscall_errno != 0 || (kernel != NULL && kernel->hung_task)) {
+            return RUN_OUTCOME_EXIT_CLASSIFIED;
+        }
+        return RUN_OUTCOME_EXIT_FAILURE;
+    }
+    return RUN_OUTCOME_UNKNOWN_STATE;
+}
+
+static int syscall_number(const char *name, size_t length) {
+    for (size_t nr = 0; nr < sys_syscall_names_size; nr++) {
+        const char *candidate = sys_syscall_names[nr];
+        if (candidate != NULL && strlen(candidate) == length && strncmp(candidate, name, length) == 0) {
+            return (int)nr;
+        }
+    }
+    return -1;
+}
+
+static int trace_config_add(SyscallTraceConfig *config, int nr) {
+    for (size_t i = 0; i < config->syscall_count; i++) {
+        if (config->syscalls[i] == nr) {
+            return 0;
+        }
+    }
+    if (config->syscall_count >= SYSCALL_TRACE_MAX) {
+        return -1;
+    }
+    config->syscalls[config->syscall_count++] = nr;
+    return 0;
+}
+
+int syscall_trace_config_parse(const char *list, SyscallTraceConfig *config) {
+    if (config == NULL) {
+        return -1;
+    }
+    config->syscall_count = 0;
+
+    if (list == NULL) {
+        /* Not every architecture has every default syscall */
+        for (size_t i = 0; i < sizeof(default_trace_syscalls) / sizeof(default_trace_syscalls[0]); i++) {
+            const char *name = default_trace_syscalls[i];
+            int nr = syscall_number(name, strlen(name));
+            if (nr >= 0 && trace_config_add(config, nr) != 0) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    const char *p = list;
+    while (*p != '\0') {
+        size_t length = strcspn(p, ",");
+        if (length > 0) {
+            int nr = syscall_number(p, length);
+            if (nr < 0 || trace_config_add(config, nr) != 0) {
+                return -1;
+            }
+        }
+        p += length;
+        if (*p == ',') {
+            p++;
+        }
+    }
+    return config->syscall_count > 0 ? 0 : -1;
+}
+
+#ifdef TRACE_AUDIT_ARCH
+/*
+ * Builds the child's seccomp filter: traced syscalls on the native ABI return
+ * SECCOMP_RET_TRACE with the syscall number as data, everything else is allowed
+ * without involving the tracer.
+ */
+static size_t build_trace_filter(const SyscallTraceConfig *config, struct sock_filter *filter) {
+    size_t n = 0;
+
+    filter[n++] = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, arch));
+    filter[n++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, TRACE_AUDIT_ARCH, 1, 0);
+    filter[n++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW);
+    filter[n++] = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, nr));
+    for (size_t i = 0; i < config->syscall_count; i++) {
+        unsigned int nr = (unsigned int)config->syscalls[i];
+        filter[n++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, nr, 0, 1);
+        filter[n++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_TRACE | (nr & SECCOMP_RET_DATA));
+    }
+    filter[n++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW);
+    return n;
+}
+
+static PendingSyscall *find_pending(PendingSyscall *pending, pid_t tid) {
+    PendingSyscall *free_slot = NULL;
+    for (size_t i = 0; i < TRACE_MAX_PENDING; i++) {
+        if (pending[i].tid == tid) {
+            return &pending[i];
+        }
+        if (pending[i].tid == 0 && free_slot == NULL) {
+            free_slot = &pending[i];
+        }
+    }
+    return free_slot;
+}
+
+/* Thread group (process) a traced task belongs to, from /proc/<tid>/status */
+static pid_t thread_group_of(pid_t tid) {
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%d/status", (int)tid);
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    char line[128];
+    pid_t tgid = -1;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strncmp(line, "Tgid:", 5) == 0) {
+            tgid = (pid_t)strtol(line + 5, NULL, 10);
+            break;
+        }
+    }
+    fclose(file);
+    return tgid;
+}
+
+/* Copies the parts of a siginfo that the failure rules use */
+static void fill_signal_info(const siginfo_t *info, ProcessResult *result) {
+    result->has_signal_info = 1;
+    result->signal_code = info->si_code;
+    if (info->si_code == SI_USER || info->si_code == SI_QUEUE || info->si_code == SI_TKILL) {
+        result->signal_sender = (int)info->si_pid;
+    } else if (info->si_code > 0 && (info->si_signo == SIGSEGV || info->si_signo == SIGBUS ||
+                                     info->si_signo == SIGILL || info->si_signo == SIGFPE)) {
+        result->has_fault_address = info->si_code != SI_KERNEL;
+        result->fault_address = (unsigned long)info->si_addr;
+    }
+}
+
+/* Records the result of a traced syscall at its syscall-exit stop */
+static void record_syscall_exit(pid_t tid, PendingSyscall *pending, ProcessResult *result) {
+    struct __ptrace_syscall_info info;
+    if (ptrace(PTRACE_GET_SYSCALL_INFO, tid, (void *)sizeof(info), &info) <= 0 ||
+        info.op != PTRACE_SYSCALL_INFO_EXIT) {
+        return;
+    }
+
+    PendingSyscall *slot = find_pending(pending, tid);
+    int nr = -1;
+    if (slot != NULL && slot->tid == tid) {
+        nr = slot->nr;
+        slot->tid = 0;
+    }
+    if (!info.exit.is_error) {
+        return;
+    }
+    /* Interrupted by a signal: the syscall restarts, the real result comes with that attempt */
+    if (-info.exit.rval >= KERNEL_ERESTARTSYS && -info.exit.rval <= KERNEL_ERESTART_RESTARTBLOCK) {
+        return;
+    }
+
+    result->failed_syscall = nr;
+    result->syscall_errno = (int)-info.exit.rval;
+    result->syscall_failures++;
+}
+
+static int traced_tasks_add(TracedTasks *tasks, pid_t tid) {
+    for (size_t i = 0; i < tasks->count; i++) {
+        if (tasks->tids[i] == tid) {
+            return 0;
+        }
+    }
+    if (tasks->count == tasks->capacity) {
+        size_t new_capacity = tasks->capacity ? tasks->capacity * 2 : 16;
+        pid_t *grown = realloc(tasks->tids, new_capacity * sizeof(*grown));
+        if (grown == NULL) {
+            return -1;
+        }
+        tasks->tids = grown;
+        tasks->capacity = new_capacity;
+    }
+    tasks->tids[tasks->count++] = tid;
+    return 0;
+}
+
+static void traced_tasks_remove(TracedTasks *tasks, size_t index) {
+    tasks->tids[index] = tasks->tids[--tasks->count];
+}
+
+/*
+ * Waits for the next state change of any traced task without touching other
+ * children of the caller: each known tid is polled with WNOHANG, and between
+ * rounds the tracer sleeps until SIGCHLD (blocked by the caller) is pending.
+ * New tasks from fork/clone are added at their parent's event stop; a stop
+ * they report earlier stays queued until then. Returns the tid, or -1 once no
+ * traced task is left.
+ */
+static pid_t wait_traced(TracedTasks *tasks, const sigset_t *sigchld, int *status) {
+    while (tasks->count > 0) {
+        for (size_t i = 0; i < tasks->count; i++) {
+            pid_t tid = tasks->tids[i];
+            pid_t got = waitpid(tid, status, WNOHANG | __WALL);
+            if (got == tid) {
+                if (WIFEXITED(*status) || WIFSIGNALED(*status)) {
+                    traced_tasks_remove(tasks, i);
+                }
+                return tid;
+            }
+            if (got < 0 && errno == ECHILD) {
+                /* Gone without a notification (e.g. a thread replaced by execve) */
+                traced_tasks_remove(tasks, i);
+                i--;
+            }
+        }
+        if (tasks->count > 0) {
+            sigwaitinfo(sigchld, NULL);
+        }
+    }
+    return -1;
+}
+
+/*
+ * Tracer loop: returns the wait status of the target once it has terminated,
+ * and in last_signal the siginfo of the last signal delivered to the target.
+ * Descendants still running at that point are not waited for. They stay
+ * attached and PTRACE_O_EXITKILL ends them when the analyzer exits; detaching
+ * instead would make their traced syscalls fail with ENOSYS.
+ */
+static int trace_until_exit(pid_t pid, ProcessResult *result, int *final_status, siginfo_t *last_signal) {
+    PendingSyscall pending[TRACE_MAX_PENDING];
+    memset(pending, 0, sizeof(pending));
+
+    TracedTasks tasks = {NULL, 0, 0};
+    if (traced_tasks_add(&tasks, pid) != 0) {
+        return -1;
+    }
+
+    /* SIGCHLD stays pending while blocked, so no state change is missed between polls */
+    sigset_t sigchld;
+    sigset_t saved_mask;
+    sigemptyset(&sigchld);
+    sigaddset(&sigchld, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &sigchld, &saved_mask);
+
+    int target_alive = 1;
+    while (target_alive) {
+        int status;
+        pid_t tid = wait_traced(&tasks, &sigchld, &status);
+        if (tid < 0) {
+            break;
+        }
+
+        if (WIFEXITED(status) || WIFSIGNALED(status)) {
+            if (tid == pid) {
+                *final_status = status;
+                target_alive = 0;
+            }
+            continue;
+        }
+        if (!WIFSTOPPED(status)) {
+            continue;
+        }
+
+        int sig = WSTOPSIG(status);
+        int event = (unsigned int)status >> 16;
+        enum __ptrace_request request = PTRACE_CONT;
+        long inject = 0;
+
+        if (sig == (SIGTRAP | 0x80)) {
+            /* Syscall-exit stop of a traced syscall (or a stray entry stop) */
+            record_syscall_exit(tid, pending, result);
+        } else if (event == PTRACE_EVENT_SECCOMP) {
+            /* Traced syscall entry: run it and stop again at its exit */
+            unsigned long nr = 0;
+            PendingSyscall *slot = find_pending(pending, tid);
+            if (slot != NULL && ptrace(PTRACE_GETEVENTMSG, tid, NULL, &nr) == 0) {
+                slot->tid = tid;
+                slot->nr = (int)nr;
+            }
+            request = PTRACE_SYSCALL;
+        } else if (event == PTRACE_EVENT_CLONE || event == PTRACE_EVENT_FORK || event == PTRACE_EVENT_VFORK) {
+            /* The new task is auto-attached; from now on it is waited for like the others */
+            unsigned long child = 0;
+            if (ptrace(PTRACE_GETEVENTMSG, tid, NULL, &child) == 0 && child != 0 &&
+                traced_tasks_add(&tasks, (pid_t)child) != 0) {
+                /* Out of memory: an untracked tracee would stay stopped forever */
+                kill((pid_t)child, SIGKILL);
+                kill(pid, SIGKILL);
+            }
+        } else if (event == PTRACE_EVENT_STOP) {
+            /* New auto-attached tracees report SIGTRAP; keep real group-stops stopped */
+            if (sig != SIGTRAP) {
+                request = PTRACE_LISTEN;
+            }
+        } else if (event == 0) {
+            /* Signal-delivery stop: pass the signal on, without losing a pending exit stop */
+            siginfo_t info;
+            if (ptrace(PTRACE_GETSIGINFO, tid, NULL, &info) == 0 && (tid == pid || thread_group_of(tid) == pid)) {
+                *last_signal = info;
+            }
+            PendingSyscall *slot = find_pending(pending, tid);
+            inject = sig;
+            request = slot != NULL && slot->tid == tid ? PTRACE_SYSCALL : PTRACE_CONT;
+        }
+
+        ptrace(request, tid, NULL, (void *)inject);
+    }
+
+    sigprocmask(SIG_SETMASK, &saved_mask, NULL);
+    free(tasks.tids);
+    return target_alive ? -1 : 0;
+}
+#endif
+
+int run_and_monitor_traced(char *program, char **args, const SyscallTraceConfig *config, ProcessResult *result) {
     if (program == NULL || args == NULL || result == NULL) {
         return -1;
     }
 
     /* Initialize result structure defensively */
     result->ran_successfully = 0;
+    result->pid = 0;
     result->exited_normally = 0;
     result->exit_code = 0;
     result->terminated_by_signal = 0;
     result->signal_number = 0;
     result->core_dumped = 0;
+    result->syscalls_traced = 0;
+    result->failed_syscall = -1;
+    result->syscall_errno = 0;
+    result->syscall_failures = 0;
+    result->has_signal_info = 0;
+    result->signal_code = 0;
+    result->signal_sender = 0;
+    result->has_fault_address = 0;
+    result->fault_address = 0;
+
+    if (config == NULL) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            /* fork() failed */
+            return -1;
+        }
+
+        if (pid == 0) {
+            /* Child process: execute the target program */
+            execvp(program, args);
+            /* If execvp returns, it failed */
+            _exit(127);  /* Standard exit code for exec failure */
+        }
+        result->pid = (int)pid;
+
+        /* Parent process: wait for child to terminate */
+        int status;
+        pid_t waited_pid = waitpid(pid, &status, 0);
+
+        if (waited_pid < 0) {
+            /* waitpid() failed */
+            return -1;
+        }
+
+        fill_result(status, result);
+        return 0;
+    }
+
+#ifdef TRACE_AUDIT_ARCH
+    if (config->syscall_count == 0 || config->syscall_count > SYSCALL_TRACE_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    struct sock_filter filter[TRACE_FILTER_MAX];
+    struct sock_fprog prog = {
+        .len = (unsigned short)build_trace_filter(config, filter),
+        .filter = filter
+    };
+
+    /* The child waits on this pipe until the tracer has attached */
+    int sync_pipe[2];
+    if (pipe(sync_pipe) != 0) {
+        return -1;
+    }
 
     pid_t pid = fork();
     if (pid < 0) {
-        /* fork() failed */
+        close(sync_pipe[0]);
+        close(sync_pipe[1]);
         return -1;
     }
 
     if (pid == 0) {
-        /* Child process: execute the target program */
+        char byte;
+        close(sync_pipe[1]);
+        while (read(sync_pipe[0], &byte, 1) < 0 && errno == EINTR) {
+        }
+        close(sync_pipe[0]);
+
+        if (prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) != 0 ||
+            prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &prog) != 0) {
+            fprintf(stderr, "Failed to install syscall trace filter: %s\n", strerror(errno));
+            _exit(127);
+        }
         execvp(program, args);
-        /* If execvp returns, it failed */
         _exit(127);  /* Standard exit code for exec failure */
     }
 
-    /* Parent process: wait for child to terminate */
-    int status;
-    pid_t waited_pid = waitpid(pid, &status, 0);
-
-    if (waited_pid < 0) {
-        /* waitpid() failed */
+    close(sync_pipe[0]);
+    result->pid = (int)pid;
+    long options = PTRACE_O_TRACESECCOMP | PTRACE_O_TRACESYSGOOD | PTRACE_O_EXITKILL |
+                   PTRACE_O_TRACECLONE | PTRACE_O_TRACEFORK | PTRACE_O_TRACEVFORK;
+    if (ptrace(PTRACE_SEIZE, pid, NULL, (void *)options) != 0) {
+        int saved_errno = errno;
+        kill(pid, SIGKILL);
+        close(sync_pipe[1]);
+        waitpid(pid, NULL, 0);
+        errno = saved_errno;
         return -1;
     }
+    close(sync_pipe[1]);
 
-    /* Mark that the program ran successfully (we got past fork/exec) */
-    result->ran_successfully = 1;
-
-    /* Analyze termination status */
-    if (WIFEXITED(status)) {
-        /* Program called exit() */
-        result->exited_normally = 1;
-        result->exit_code = WEXITSTATUS(status);
-    } else if (WIFSIGNALED(status)) {
-        /* Program was terminated by a signal */
-        result->terminated_by_signal = 1;
-        result->signal_number = WTERMSIG(status);
-        result->core_dumped = WCOREDUMP(status) ? 1 : 0;
-    } else {
-        /* Unknown termination state (should not happen normally) */
-        /* Leave flags as 0 to indicate unknown state */
+    result->syscalls_traced = 1;
+    int status;
+    siginfo_t last_signal;
+    memset(&last_signal, 0, sizeof(last_signal));
+    if (trace_until_exit(pid, result, &status, &last_signal) != 0) {
+        int saved_errno = errno;
+        kill(pid, SIGKILL);
+        errno = saved_errno;
+        return -1;
     }
 
+    fill_result(status, result);
+    if (result->terminated_by_signal && last_signal.si_signo == result->signal_number) {
+        fill_signal_info(&last_signal, result);
+    }
     return 0;
+#else
+    /* No seccomp audit architecture known for this build target */
+    errno = ENOSYS;
+    return -1;
+#endif
 }
 
+int run_and_monitor(char *program, char **args, ProcessResult *result) {
+    return run_and_monitor_traced(program, args, NULL, result);
+}
@@ -0,0 +1,243 @@
+#define _POSIX_C_SOURCE 200809L
+#include "query_command.h"
+#include "history_store.h"
+#include "signal_analyzer.h"
+#include "errno_mapper.h"
+#include "failure_rules.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <time.h>
+
+#define MAX_ERRNO_SCAN 4096
+
+static void print_query_usage(void) {
+    fprintf(stderr, "Usage: auto_analyze query [-H <history_dir>] [-w <column>=<value>]... [-g <column>] [--since <epoch>] [--until <epoch>]\n");
+    fprintf(stderr, "Columns: timestamp, target, signal, errno, exit, type, rule, signature (group-by also accepts day)\n");
+    fprintf(stderr, "Values:  signal and errno accept names (SIGBUS, ENOMEM), type accepts names (\"Memory Corruption\", none)\n");
+}
+
+static int parse_integer(const char *text, int64_t *value) {
+    char *end;
+    errno = 0;
+    long long parsed = strtoll(text, &end, 0);
+    if (errno != 0 || end == text || *end != '\0') {
+        return -1;
+    }
+    *value = (int64_t)parsed;
+    return 0;
+}
+
+/* Converts a filter value to the stored representation of its column */
+static int parse_filter_value(const HistoryStore *store, int column, const char *text, int64_t *value) {
+    switch (column) {
+        case HISTORY_COL_TARGET:
+            *value = history_target_id(store, text);  /* -1 never matches */
+            return 0;
+        case HISTORY_COL_SIGNAL:
+            if (parse_integer(text, value) == 0) {
+                return 0;
+            }
+            for (int n = 1; n < 256; n++) {
+                const SignalInfo *info = analyze_signal(n);
+                if (info != NULL && (strcasecmp(info->name, text) == 0 || strcasecmp(info->name + 3, text) == 0)) {
+                    *value = n;
+                    return 0;
+                }
+            }
+            return -1;
+        case HISTORY_COL_ERRNO:
+            if (parse_integer(text, value) == 0) {
+                return 0;
+            }
+            for (int n = 1; n < MAX_ERRNO_SCAN; n++) {
+                const ErrnoInfo *info = analyze_errno(n);
+                if (info != NULL && strcasecmp(info->name, text) == 0) {
+                    *value = n;
+                    return 0;
+                }
+            }
+            return -1;
+        case HISTORY_COL_FAILURE_TYPE:
+            if (parse_integer(text, value) == 0) {
+                return 0;
+            }
+            if (strcasecmp(text, "none") == 0) {
+                *value = HISTORY_NO_FAILURE;
+                return 0;
+            }
+            for (int t = FAILURE_MEMORY_CORRUPTION; t <= FAILURE_EXTERNAL_TERMINATION; t++) {
+                if (strcasecmp(failure_type_name((FailureType)t), text) == 0) {
+                    *value = t;
+                    return 0;
+                }
+            }
+            return -1;
+        case HISTORY_COL_SIGNATURE: {
+            char *end;
+            errno = 0;
+            unsigned long long parsed = strtoull(text, &end, 0);
+            if (errno != 0 || end == text || *end != '\0') {
+                return -1;
+            }
+            *value = (int64_t)(uint64_t)parsed;
+            return 0;
+        }
+        default:
+            return parse_integer(text, value);
+    }
+}
+
+static void print_group_key(const HistoryStore *store, int column, int64_t key) {
+    switch (column) {
+        case HISTORY_COL_TARGET: {
+            const char *name = history_target_name(store, key);
+            printf("%-32s", name != NULL ? name : "?");
+            break;
+        }
+        case HISTORY_COL_SIGNAL: {
+            const SignalInfo *info = analyze_signal((int)key);
+            if (info != NULL) {
+                printf("%-32s", info->name);
+            } else {
+                printf("%-32s", key < 0 ? "none" : "?");
+            }
+            break;
+        }
+        case HISTORY_COL_ERRNO: {
+            const ErrnoInfo *info = analyze_errno((int)key);
+            printf("%-32s", info != NULL ? info->name : (key == 0 ? "none" : "?"));
+            break;
+        }
+        case HISTORY_COL_FAILURE_TYPE:
+            printf("%-32s", key == HISTORY_NO_FAILURE ? "none" : failure_type_name((FailureType)key));
+            break;
+        case HISTORY_COL_SIGNATURE:
+            printf("0x%016" PRIx64 "%14s", (uint64_t)key, "");
+            break;
+        case HISTORY_GROUP_DAY: {
+            time_t seconds = (time_t)(key * 86400);
+            struct tm tm_utc;
+            char day[16];
+            gmtime_r(&seconds, &tm_utc);
+            strftime(day, sizeof(day), "%Y-%m-%d", &tm_utc);
+            printf("%-32s", day);
+            break;
+        }
+        default:
+            printf("%-32" PRId64, key);
+            break;
+    }
+}
+
+int run_query_command(int argc, char *argv[], const char *history_dir) {
+    HistoryQuery query;
+    memset(&query, 0, sizeof(query));
+    query.since = INT64_MIN;
+    query.until = INT64_MAX;
+    query.group_by = HISTORY_GROUP_NONE;
+
+    const char *where[HISTORY_MAX_FILTERS];
+    size_t where_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Error: Option %s requires an argument\n", argv[i]);
+            print_query_usage();
+            return EXIT_FAILURE;
+        }
+        if (strcmp(argv[i], "-H") == 0) {
+            history_dir = argv[++i];
+        } else if (strcmp(argv[i], "-w") == 0) {
+            if (where_count == HISTORY_MAX_FILTERS) {
+                fprintf(stderr, "Error: At most %d filters are supported\n", HISTORY_MAX_FILTERS);
+                return EXIT_FAILURE;
+            }
+            where[where_count++] = argv[++i];
+        } else if (strcmp(argv[i], "-g") == 0) {
+            query.group_by = history_column_from_name(argv[++i]);
+            if (query.group_by < 0) {
+                fprintf(stderr, "Error: Unknown column: %s\n", argv[i]);
+                print_query_usage();
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--since") == 0 || strcmp(argv[i], "--until") == 0) {
+            int64_t bound;
+            if (parse_integer(argv[i + 1], &bound) != 0) {
+                fprintf(stderr, "Error: Invalid timestamp: %s\n", argv[i + 1]);
+                return EXIT_FAILURE;
+            }
+            if (argv[i][2] == 's') {
+                query.since = bound;
+            } else {
+                query.until = bound;
+            }
+            i++;
+        } else {
+            fprintf(stderr, "Error: Unknown option: %s\n", argv[i]);
+            print_query_usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (history_dir == NULL) {
+        fprintf(stderr, "Error: No history store given (use -H or set AUTO_ANALYZE_HISTORY)\n");
+        return EXIT_FAILURE;
+    }
+
+    HistoryStore store;
+    if (history_store_open(history_dir, &store) != 0) {
+        fprintf(stderr, "Error: Failed to open history store %s: %s\n", history_dir, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    for (size_t w = 0; w < where_count; w++) {
+        char column_name[32];
+        const char *equals = strchr(where[w], '=');
+        size_t name_length = equals != NULL ? (size_t)(equals - where[w]) : 0;
+        if (equals == NULL || name_length >= sizeof(column_name)) {
+            fprintf(stderr, "Error: Filter must be <column>=<value>: %s\n", where[w]);
+            history_store_close(&store);
+            return EXIT_FAILURE;
+        }
+        memcpy(column_name, where[w], name_length);
+        column_name[name_length] = '\0';
+
+        int column = history_column_from_name(column_name);
+        HistoryFilter *filter = &query.filters[query.filter_count];
+        if (column < 0 || column >= HISTORY_COLUMN_COUNT ||
+            parse_filter_value(&store, column, equals + 1, &filter->value) != 0) {
+            fprintf(stderr, "Error: Invalid filter: %s\n", where[w]);
+            history_store_close(&store);
+            return EXIT_FAILURE;
+        }
+        filter->column = (HistoryColumn)column;
+        query.filter_count++;
+    }
+
+    HistoryQueryResult result;
+    if (history_query(&store, &query, &result) != 0) {
+        fprintf(stderr, "Error: Query failed\n");
+        history_store_close(&store);
+        return EXIT_FAILURE;
+    }
+
+    if (query.group_by != HISTORY_GROUP_NONE) {
+        printf("%-32s %s\n", history_column_name(query.group_by), "count");
+        for (size_t g = 0; g < result.group_count; g++) {
+            print_group_key(&store, query.group_by, result.groups[g].key);
+            printf(" %" PRIu64 "\n", result.groups[g].count);
+        }
+        printf("\n");
+    }
+    printf("Rows scanned: %" PRIu64 "\n", result.rows_scanned);
+    printf("Rows matched: %" PRIu64 "\n", result.rows_matched);
+
+    history_query_result_free(&result);
+    history_store_close(&store);
+    return EXIT_SUCCESS;
+}
@@ -1,21 +1,33 @@
 #include "signal_analyzer.h"
+#include "sys_tables.h"
 #include <string.h>
 
-static const SignalInfo signal_table[] = {
-    {SIGSEGV, "SIGSEGV", "Segmentation fault - invalid memory access"},
-    {SIGABRT, "SIGABRT", "Abort signal - abnormal termination"},
-    {SIGBUS, "SIGBUS", "Bus error - invalid memory access alignment"},
-    {SIGFPE, "SIGFPE", "Floating-point exception - arithmetic error"}
-};
+const SignalInfo *analyze_signal(int signal_num) {
+    if (signal_num <= 0 || (size_t)signal_num >= sys_signal_table_size) {
+        return NULL;
+    }
+    const SignalInfo *info = &sys_signal_table[signal_num];
+    return info->name != NULL ? info : NULL;
+}
+
+const SiCodeInfo *analyze_si_code(int signal_num, int si_code) {
+    if (signal_num <= 0 || (size_t)signal_num >= sys_signal_table_size) {
+        return NULL;
+    }
 
-static const size_t signal_table_size = sizeof(signal_table) / sizeof(signal_table[0]);
+    const SiCodeTable *table = &sys_si_code_tables[signal_num];
+    const SiCodeInfo *info = NULL;
 
-const SignalInfo *analyze_signal(int signal_num) {
-    for (size_t i = 0; i < signal_table_size; i++) {
-        if (signal_table[i].signal_num == signal_num) {
-            return &signal_table[i];
+    if (si_code == table->codes[0].si_code) {
+        /* SI_KERNEL lives in slot 0 so it can carry the signal's own mapping */
+        info = &table->codes[0];
+    } else if (si_code > 0) {
+        if ((size_t)si_code < table->count) {
+            info = &table->codes[si_code];
         }
+    } else if (si_code >= sys_si_code_generic_min) {
+        info = &sys_si_code_generic_table[si_code - sys_si_code_generic_min];
     }
-    return NULL;
-}
 
+    return (info != NULL && info->name != NULL) ? info : NULL;
+}
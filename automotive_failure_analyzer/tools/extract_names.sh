@@ -0,0 +1,45 @@
+#!/bin/sh
+# Extracts errno, signal, si_code and system call names from the system headers and emits
+# them as X-macro lists for tools/gen_tables.c.
+# Usage: extract_names.sh <cc>
+#
+# The macro dump is sorted first: cc -E -dM emits macros in hash order, and for
+# aliases with the same value (EAGAIN/EWOULDBLOCK, SIGABRT/SIGIOT) gen_tables
+# keeps the first name it sees, so sorting makes the choice the same on every
+# toolchain.
+
+CC=${1:-cc}
+
+printf '#include <errno.h>\n#include <signal.h>\n#include <sys/syscall.h>\n' | $CC -E -dM -D_GNU_SOURCE - | LC_ALL=C sort | awk '
+$1 == "#define" && $2 ~ /^E[A-Z0-9]+$/ && $3 ~ /^[0-9]+$/ {
+    errnos[++errno_count] = $2
+}
+$1 == "#define" && $2 ~ /^SIG[A-Z0-9]+$/ && $3 ~ /^[0-9]+$/ {
+    signals[++signal_count] = $2
+}
+$1 == "#define" && $2 ~ /^(SEGV|BUS|ILL|FPE|TRAP|CLD|POLL|SYS|SI)_[A-Z0-9_]+$/ &&
+        ($3 == $2 || $3 ~ /^-?[0-9]+$/ || $3 ~ /^0x[0-9a-fA-F]+$/) {
+    codes[++code_count] = $2
+}
+$1 == "#define" && $2 ~ /^SYS_[a-z0-9_]+$/ && $3 ~ /^__NR_/ {
+    syscalls[++syscall_count] = substr($2, 5)
+}
+END {
+    print "/* Generated by tools/extract_names.sh - do not edit */"
+    print "#define ERRNO_NAMES \\"
+    for (i = 1; i <= errno_count; i++) print "    ERRNO_NAME(" errnos[i] ") \\"
+    print ""
+    print "#define SIGNAL_NAMES \\"
+    for (i = 1; i <= signal_count; i++) print "    SIGNAL_NAME(" signals[i] ") \\"
+    print ""
+    print "#define SI_CODE_NAMES \\"
+    for (i = 1; i <= code_count; i++) {
+        prefix = codes[i]
+        sub(/_.*/, "", prefix)
+        print "    SI_CODE_NAME(" prefix ", " codes[i] ") \\"
+    }
+    print ""
+    print "#define SYSCALL_NAMES \\"
+    for (i = 1; i <= syscall_count; i++) print "    SYSCALL_NAME(" syscalls[i] ") \\"
+    print ""
+}'
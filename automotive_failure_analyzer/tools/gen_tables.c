@@ -0,0 +1,463 @@
+/*
+ * Build-time generator for the dense signal, si_code, errno and system call
+ * lookup tables.
+ * Compiled and run by the Makefile; names come from gen/sys_names.h (produced
+ * by tools/extract_names.sh from the system headers), descriptions from the C
+ * library, and default failure types from the policy tables below.
+ * Writes a C source file defining the tables declared in sys_tables.h to stdout.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include "failure_rules.h"
+#include "sys_names.h"
+
+#define MAX_FAMILY_CODE 64
+
+typedef struct {
+    const char *name;
+    int value;
+} NamedValue;
+
+typedef struct {
+    const char *prefix;
+    const char *name;
+    int value;
+} NamedCode;
+
+static const NamedValue errno_names[] = {
+#define ERRNO_NAME(n) {#n, n},
+    ERRNO_NAMES
+#undef ERRNO_NAME
+};
+
+static const NamedValue signal_names[] = {
+#define SIGNAL_NAME(n) {#n, n},
+    SIGNAL_NAMES
+#undef SIGNAL_NAME
+};
+
+static const NamedCode si_code_names[] = {
+#define SI_CODE_NAME(prefix, n) {#prefix, #n, n},
+    SI_CODE_NAMES
+#undef SI_CODE_NAME
+};
+
+static const NamedValue syscall_names[] = {
+#define SYSCALL_NAME(n) {#n, SYS_##n},
+    SYSCALL_NAMES
+#undef SYSCALL_NAME
+};
+
+#define COUNT(array) (sizeof(array) / sizeof((array)[0]))
+
+/* Signal policy: default failure type and, where the rule engine historically
+ * printed a more specific text, the description to use instead of strsignal().
+ * Signals not listed here default to FAILURE_EXTERNAL_TERMINATION. */
+static const struct {
+    int signal_num;
+    FailureType failure_type;
+    const char *description;
+} signal_policy[] = {
+    {SIGSEGV, FAILURE_MEMORY_CORRUPTION, "Segmentation fault - invalid memory access"},
+    {SIGBUS, FAILURE_MEMORY_CORRUPTION, "Bus error - invalid memory access alignment"},
+    {SIGFPE, FAILURE_INVALID_STATE, "Floating-point exception - arithmetic error"},
+    {SIGABRT, FAILURE_INVALID_STATE, "Abort signal - abnormal termination"},
+    {SIGILL, FAILURE_INVALID_STATE, NULL},
+    {SIGTRAP, FAILURE_INVALID_STATE, NULL},
+    {SIGSYS, FAILURE_INVALID_STATE, NULL},
+    {SIGPIPE, FAILURE_INVALID_STATE, NULL},
+    {SIGXCPU, FAILURE_RESOURCE_EXHAUSTION, NULL},
+    {SIGXFSZ, FAILURE_RESOURCE_EXHAUSTION, NULL},
+    {SIGALRM, FAILURE_TIMING_RACE, NULL},
+    {SIGVTALRM, FAILURE_TIMING_RACE, NULL},
+    {SIGPROF, FAILURE_TIMING_RACE, NULL}
+};
+
+/* Errno policy. Values not listed here default to FAILURE_INVALID_STATE. */
+static const struct {
+    int err_val;
+    FailureType failure_type;
+} errno_policy[] = {
+    {EFAULT, FAILURE_MEMORY_CORRUPTION},
+    {ENOMEM, FAILURE_RESOURCE_EXHAUSTION},
+    {ENOSPC, FAILURE_RESOURCE_EXHAUSTION},
+    {EDQUOT, FAILURE_RESOURCE_EXHAUSTION},
+    {EMFILE, FAILURE_RESOURCE_EXHAUSTION},
+    {ENFILE, FAILURE_RESOURCE_EXHAUSTION},
+    {EAGAIN, FAILURE_RESOURCE_EXHAUSTION},
+    {ENOBUFS, FAILURE_RESOURCE_EXHAUSTION},
+    {EMLINK, FAILURE_RESOURCE_EXHAUSTION},
+    {ENOLCK, FAILURE_RESOURCE_EXHAUSTION},
+    {EUSERS, FAILURE_RESOURCE_EXHAUSTION},
+    {E2BIG, FAILURE_RESOURCE_EXHAUSTION},
+    {EFBIG, FAILURE_RESOURCE_EXHAUSTION},
+    {ETIMEDOUT, FAILURE_TIMING_RACE},
+    {EDEADLK, FAILURE_TIMING_RACE},
+    {EBUSY, FAILURE_TIMING_RACE},
+    {EALREADY, FAILURE_TIMING_RACE},
+    {EINPROGRESS, FAILURE_TIMING_RACE},
+    {EOWNERDEAD, FAILURE_TIMING_RACE},
+    {ENOTRECOVERABLE, FAILURE_TIMING_RACE},
+#ifdef ETIME
+    {ETIME, FAILURE_TIMING_RACE},
+#endif
+};
+
+/* si_code descriptions (the C library provides none) */
+static const struct {
+    const char *name;
+    const char *description;
+} si_code_descriptions[] = {
+    {"SI_USER", "Sent by kill() or raise()"},
+    {"SI_KERNEL", "Sent by the kernel"},
+    {"SI_QUEUE", "Sent by sigqueue()"},
+    {"SI_TIMER", "POSIX timer expired"},
+    {"SI_MESGQ", "POSIX message queue state changed"},
+    {"SI_ASYNCIO", "Asynchronous I/O completed"},
+    {"SI_SIGIO", "Queued SIGIO"},
+    {"SI_TKILL", "Sent by tkill() or tgkill()"},
+    {"SI_DETHREAD", "Sent by execve() killing subsidiary threads"},
+    {"SI_ASYNCNL", "Asynchronous name lookup completed"},
+    {"SEGV_MAPERR", "Address not mapped to object"},
+    {"SEGV_ACCERR", "Invalid permissions for mapped object"},
+    {"SEGV_BNDERR", "Failed address bound checks"},
+    {"SEGV_PKUERR", "Access denied by memory protection keys"},
+    {"SEGV_ACCADI", "ADI not enabled for mapped object"},
+    {"SEGV_ADIDERR", "Disrupting MCD error"},
+    {"SEGV_ADIPERR", "Precise MCD exception"},
+    {"SEGV_MTEAERR", "Asynchronous memory tag check fault"},
+    {"SEGV_MTESERR", "Synchronous memory tag check fault"},
+    {"SEGV_CPERR", "Control protection fault"},
+    {"BUS_ADRALN", "Invalid address alignment"},
+    {"BUS_ADRERR", "Nonexistent physical address"},
+    {"BUS_OBJERR", "Object-specific hardware error"},
+    {"BUS_MCEERR_AR", "Hardware memory error consumed on a machine check: action required"},
+    {"BUS_MCEERR_AO", "Hardware memory error detected in process but not consumed: action optional"},
+    {"ILL_ILLOPC", "Illegal opcode"},
+    {"ILL_ILLOPN", "Illegal operand"},
+    {"ILL_ILLADR", "Illegal addressing mode"},
+    {"ILL_ILLTRP", "Illegal trap"},
+    {"ILL_PRVOPC", "Privileged opcode"},
+    {"ILL_PRVREG", "Privileged register"},
+    {"ILL_COPROC", "Coprocessor error"},
+    {"ILL_BADSTK", "Internal stack error"},
+    {"ILL_BADIADDR", "Unimplemented instruction address"},
+    {"FPE_INTDIV", "Integer divide by zero"},
+    {"FPE_INTOVF", "Integer overflow"},
+    {"FPE_FLTDIV", "Floating-point divide by zero"},
+    {"FPE_FLTOVF", "Floating-point overflow"},
+    {"FPE_FLTUND", "Floating-point underflow"},
+    {"FPE_FLTRES", "Floating-point inexact result"},
+    {"FPE_FLTINV", "Floating-point invalid operation"},
+    {"FPE_FLTSUB", "Subscript out of range"},
+    {"FPE_FLTUNK", "Undiagnosed floating-point exception"},
+    {"FPE_CONDTRAP", "Trap on condition"},
+    {"TRAP_BRKPT", "Process breakpoint"},
+    {"TRAP_TRACE", "Process trace trap"},
+    {"TRAP_BRANCH", "Process taken branch trap"},
+    {"TRAP_HWBKPT", "Hardware breakpoint/watchpoint"},
+    {"TRAP_UNK", "Undiagnosed trap"},
+    {"TRAP_PERF", "Perf event with sigtrap=1"},
+    {"CLD_EXITED", "Child has exited"},
+    {"CLD_KILLED", "Child was killed"},
+    {"CLD_DUMPED", "Child terminated abnormally"},
+    {"CLD_TRAPPED", "Traced child has trapped"},
+    {"CLD_STOPPED", "Child has stopped"},
+    {"CLD_CONTINUED", "Stopped child has continued"},
+    {"POLL_IN", "Data input available"},
+    {"POLL_OUT", "Output buffers available"},
+    {"POLL_MSG", "Input message available"},
+    {"POLL_ERR", "I/O error"},
+    {"POLL_PRI", "High priority input available"},
+    {"POLL_HUP", "Device disconnected"},
+    {"SYS_SECCOMP", "Seccomp triggered"},
+    {"SYS_USER_DISPATCH", "Syscall user dispatch triggered"}
+};
+
+/* si_code name prefix -> signal the codes belong to */
+static const struct {
+    const char *prefix;
+    int signal_num;
+} si_code_families[] = {
+    {"SEGV", SIGSEGV},
+    {"BUS", SIGBUS},
+    {"ILL", SIGILL},
+    {"FPE", SIGFPE},
+    {"TRAP", SIGTRAP},
+    {"CLD", SIGCHLD},
+    {"POLL", SIGPOLL},
+    {"SYS", SIGSYS}
+};
+
+static const char *failure_type_enum_name(FailureType type) {
+    switch (type) {
+        case FAILURE_MEMORY_CORRUPTION:
+            return "FAILURE_MEMORY_CORRUPTION";
+        case FAILURE_INVALID_STATE:
+            return "FAILURE_INVALID_STATE";
+        case FAILURE_RESOURCE_EXHAUSTION:
+            return "FAILURE_RESOURCE_EXHAUSTION";
+        case FAILURE_TIMING_RACE:
+            return "FAILURE_TIMING_RACE";
+        case FAILURE_EXTERNAL_TERMINATION:
+        default:
+            return "FAILURE_EXTERNAL_TERMINATION";
+    }
+}
+
+static void print_string(const char *text) {
+    putchar('"');
+    for (const char *p = text; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            putchar('\\');
+        }
+        putchar(*p);
+    }
+    putchar('"');
+}
+
+static void print_entry(int index, int value, const char *name, const char *description, FailureType type) {
+    printf("    [%d] = {%d, ", index, value);
+    print_string(name);
+    printf(", ");
+    print_string(description);
+    printf(", %s},\n", failure_type_enum_name(type));
+}
+
+/* Signal names, including synthesized real-time names (SIGRTMIN+n / SIGRTMAX-n) */
+static char signal_name_buf[_NSIG][32];
+static const char *signal_name[_NSIG];
+static int signal_reserved[_NSIG];
+
+static FailureType signal_failure_type(int signal_num) {
+    for (size_t i = 0; i < COUNT(signal_policy); i++) {
+        if (signal_policy[i].signal_num == signal_num) {
+            return signal_policy[i].failure_type;
+        }
+    }
+    return FAILURE_EXTERNAL_TERMINATION;
+}
+
+static const char *signal_description(int signal_num) {
+    if (signal_reserved[signal_num]) {
+        return "Real-time signal reserved by the C library";
+    }
+    for (size_t i = 0; i < COUNT(signal_policy); i++) {
+        if (signal_policy[i].signal_num == signal_num && signal_policy[i].description != NULL) {
+            return signal_policy[i].description;
+        }
+    }
+    return strsignal(signal_num);
+}
+
+static FailureType errno_failure_type(int err_val) {
+    for (size_t i = 0; i < COUNT(errno_policy); i++) {
+        if (errno_policy[i].err_val == err_val) {
+            return errno_policy[i].failure_type;
+        }
+    }
+    return FAILURE_INVALID_STATE;
+}
+
+static const char *si_code_description(const char *name) {
+    for (size_t i = 0; i < COUNT(si_code_descriptions); i++) {
+        if (strcmp(si_code_descriptions[i].name, name) == 0) {
+            return si_code_descriptions[i].description;
+        }
+    }
+    return name;
+}
+
+static int si_code_family_signal(const char *prefix) {
+    for (size_t i = 0; i < COUNT(si_code_families); i++) {
+        if (strcmp(si_code_families[i].prefix, prefix) == 0) {
+            return si_code_families[i].signal_num;
+        }
+    }
+    return 0;
+}
+
+static void build_signal_names(void) {
+    for (size_t i = 0; i < COUNT(signal_names); i++) {
+        int n = signal_names[i].value;
+        if (n > 0 && n < _NSIG && signal_name[n] == NULL) {
+            signal_name[n] = signal_names[i].name;
+        }
+    }
+
+    int rtmin = SIGRTMIN;
+    int rtmax = SIGRTMAX;
+    for (int n = 1; n < _NSIG; n++) {
+        if (signal_name[n] != NULL) {
+            continue;
+        }
+        if (n == rtmin) {
+            snprintf(signal_name_buf[n], sizeof(signal_name_buf[n]), "SIGRTMIN");
+        } else if (n == rtmax) {
+            snprintf(signal_name_buf[n], sizeof(signal_name_buf[n]), "SIGRTMAX");
+        } else if (n > rtmin && n < rtmax && n - rtmin <= (rtmax - rtmin) / 2) {
+            snprintf(signal_name_buf[n], sizeof(signal_name_buf[n]), "SIGRTMIN+%d", n - rtmin);
+        } else if (n > rtmin && n < rtmax) {
+            snprintf(signal_name_buf[n], sizeof(signal_name_buf[n]), "SIGRTMAX-%d", rtmax - n);
+        } else {
+            /* Kernel real-time signals reserved by the C library */
+            snprintf(signal_name_buf[n], sizeof(signal_name_buf[n]), "SIG%d", n);
+            signal_reserved[n] = 1;
+        }
+        signal_name[n] = signal_name_buf[n];
+    }
+}
+
+static void emit_signal_table(void) {
+    printf("const SignalInfo sys_signal_table[%d] = {\n", _NSIG);
+    for (int n = 1; n < _NSIG; n++) {
+        print_entry(n, n, signal_name[n], signal_description(n), signal_failure_type(n));
+    }
+    printf("};\n\nconst size_t sys_signal_table_size = %d;\n\n", _NSIG);
+}
+
+static void emit_errno_table(void) {
+    int max_errno = 0;
+    for (size_t i = 0; i < COUNT(errno_names); i++) {
+        if (errno_names[i].value > max_errno) {
+            max_errno = errno_names[i].value;
+        }
+    }
+
+    const char **names = calloc((size_t)max_errno + 1, sizeof(*names));
+    if (names == NULL) {
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < COUNT(errno_names); i++) {
+        int v = errno_names[i].value;
+        if (v > 0 && names[v] == NULL) {
+            names[v] = errno_names[i].name;
+        }
+    }
+
+    printf("const ErrnoInfo sys_errno_table[%d] = {\n", max_errno + 1);
+    for (int v = 1; v <= max_errno; v++) {
+        if (names[v] != NULL) {
+            print_entry(v, v, names[v], strerror(v), errno_failure_type(v));
+        }
+    }
+    printf("};\n\nconst size_t sys_errno_table_size = %d;\n\n", max_errno + 1);
+    free(names);
+}
+
+static void emit_si_code_tables(void) {
+    /* Signal-specific codes: one table per signal, SI_KERNEL in slot 0 */
+    int kernel_code = SI_KERNEL;
+    int table_size[_NSIG];
+
+    for (int n = 1; n < _NSIG; n++) {
+        const char *names[MAX_FAMILY_CODE] = {NULL};
+        int size = 1;
+
+        for (size_t i = 0; i < COUNT(si_code_names); i++) {
+            const NamedCode *code = &si_code_names[i];
+            if (si_code_family_signal(code->prefix) != n) {
+                continue;
+            }
+            if (code->value <= 0 || code->value >= MAX_FAMILY_CODE) {
+                fprintf(stderr, "gen_tables: skipping %s (%d) out of range\n", code->name, code->value);
+                continue;
+            }
+            if (names[code->value] == NULL) {
+                names[code->value] = code->name;
+            }
+            if (code->value + 1 > size) {
+                size = code->value + 1;
+            }
+        }
+
+        FailureType type = signal_failure_type(n);
+        printf("static const SiCodeInfo si_codes_%d[%d] = {\n", n, size);
+        print_entry(0, kernel_code, "SI_KERNEL", si_code_description("SI_KERNEL"), type);
+        for (int c = 1; c < size; c++) {
+            if (names[c] != NULL) {
+                print_entry(c, c, names[c], si_code_description(names[c]), type);
+            }
+        }
+        printf("};\n\n");
+        table_size[n] = size;
+    }
+
+    printf("const SiCodeTable sys_si_code_tables[%d] = {\n", _NSIG);
+    for (int n = 1; n < _NSIG; n++) {
+        printf("    [%d] = {si_codes_%d, %d},\n", n, n, table_size[n]);
+    }
+    printf("};\n\n");
+
+    /* Generic codes sent from user space (<= 0), independent of the signal */
+    int generic_min = 0;
+    for (size_t i = 0; i < COUNT(si_code_names); i++) {
+        const NamedCode *code = &si_code_names[i];
+        if (strcmp(code->prefix, "SI") == 0 && code->value <= 0 && code->value < generic_min) {
+            generic_min = code->value;
+        }
+    }
+
+    printf("const SiCodeInfo sys_si_code_generic_table[%d] = {\n", 1 - generic_min);
+    for (int v = generic_min; v <= 0; v++) {
+        for (size_t i = 0; i < COUNT(si_code_names); i++) {
+            const NamedCode *code = &si_code_names[i];
+            if (strcmp(code->prefix, "SI") == 0 && code->value == v) {
+                print_entry(v - generic_min, v, code->name, si_code_description(code->name),
+                            FAILURE_EXTERNAL_TERMINATION);
+                break;
+            }
+        }
+    }
+    printf("};\n\n");
+    printf("const int sys_si_code_generic_min = %d;\n", generic_min);
+    printf("const size_t sys_si_code_generic_size = %d;\n", 1 - generic_min);
+}
+
+static void emit_syscall_table(void) {
+    int max_nr = 0;
+    for (size_t i = 0; i < COUNT(syscall_names); i++) {
+        if (syscall_names[i].value > max_nr) {
+            max_nr = syscall_names[i].value;
+        }
+    }
+
+    const char **names = calloc((size_t)max_nr + 1, sizeof(*names));
+    if (names == NULL) {
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < COUNT(syscall_names); i++) {
+        int nr = syscall_names[i].value;
+        if (nr >= 0 && names[nr] == NULL) {
+            names[nr] = syscall_names[i].name;
+        }
+    }
+
+    printf("\nconst char *const sys_syscall_names[%d] = {\n", max_nr + 1);
+    for (int nr = 0; nr <= max_nr; nr++) {
+        if (names[nr] != NULL) {
+            printf("    [%d] = ", nr);
+            print_string(names[nr]);
+            printf(",\n");
+        }
+    }
+    printf("};\n\nconst size_t sys_syscall_names_size = %d;\n", max_nr + 1);
+    free(names);
+}
+
+int main(void) {
+    build_signal_names();
+
+    printf("/* Generated by tools/gen_tables.c - do not edit */\n");
+    printf("#include \"sys_tables.h\"\n\n");
+    emit_signal_table();
+    emit_errno_table();
+    emit_si_code_tables();
+    emit_syscall_table();
+    return 0;
+}
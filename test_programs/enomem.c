@@ -6,13 +6,15 @@
 #include <string.h>
 
 int main(void) {
-    size_t huge_size = (size_t)-1;  /* Maximum size_t value */
+    /* Larger than any user address space, but small enough that the C library
+     * passes the request on to mmap()/brk() instead of rejecting it up front */
+    size_t huge_size = (size_t)1 << 62;
     void *p = malloc(huge_size);
     
     if (p == NULL) {
         if (errno == ENOMEM) {
             printf("ENOMEM detected: %s\n", strerror(errno));
-            return 0;  /* Successfully triggered ENOMEM */
+            return 1;  /* Allocation failed, which is the failure under test */
         } else {
             printf("malloc failed with errno: %d\n", errno);
             return 1;
@@ -21,6 +23,6 @@ int main(void) {
     
     free(p);
     printf("Warning: ENOMEM not triggered (system allowed allocation)\n");
-    return 1;
+    return 0;
 }
 
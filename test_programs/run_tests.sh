@@ -54,6 +54,7 @@ run_test() {
     local test_name=$1
     local test_program=$2
     local expected_type=$3
+    local analyzer_opts=$4
     
     TOTAL=$((TOTAL + 1))
     
@@ -70,7 +71,7 @@ run_test() {
     fi
     
     # Run the analyzer
-    if "$ANALYZER" --run "$test_program" 2>&1; then
+    if "$ANALYZER" $analyzer_opts --run "$test_program" 2>&1; then
         echo ""
         echo -e "${GREEN}✓ Test completed${NC}"
         PASSED=$((PASSED + 1))
@@ -88,6 +89,33 @@ run_test() {
     echo ""
 }
 
+# Function to run an analyzer command and check its output for an expected line
+run_check() {
+    local test_name=$1
+    local expected_text=$2
+    shift 2
+
+    TOTAL=$((TOTAL + 1))
+
+    echo -e "${BLUE}━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━${NC}"
+    echo -e "${BLUE}Test: $test_name${NC}"
+    echo -e "${BLUE}━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━${NC}"
+    echo ""
+
+    local output
+    output=$("$ANALYZER" "$@" 2>&1) || true
+    echo "$output"
+    echo ""
+    if printf '%s\n' "$output" | grep -qF -- "$expected_text"; then
+        echo -e "${GREEN}✓ Found: $expected_text${NC}"
+        PASSED=$((PASSED + 1))
+    else
+        echo -e "${RED}✗ Expected output containing: $expected_text${NC}"
+        FAILED=$((FAILED + 1))
+    fi
+    echo ""
+}
+
 # Run all tests
 echo -e "${YELLOW}Running tests...${NC}"
 echo ""
@@ -107,17 +135,15 @@ run_test "SIGABRT (Abort Signal)" "$BIN_DIR/abort" "INVALID_STATE"
 # Test 5: SIGFPE (Invalid State)
 run_test "SIGFPE (Floating-Point Exception)" "$BIN_DIR/sigfpe" "INVALID_STATE"
 
-# Test 6: SIGBUS (Memory Corruption) - may not trigger on all systems
-if [ -f "$BIN_DIR/sigbus" ]; then
-    run_test "SIGBUS (Bus Error)" "$BIN_DIR/sigbus" "MEMORY_CORRUPTION"
-fi
+# Test 6: SIGBUS (Memory Corruption)
+run_test "SIGBUS (Bus Error)" "$BIN_DIR/sigbus" "MEMORY_CORRUPTION"
 
-# Test 7: Unknown signal (SIGKILL)
-run_test "Unknown Signal (SIGKILL)" "$BIN_DIR/unknown_signal" "UNKNOWN"
+# Test 7: SIGKILL (External Termination)
+run_test "SIGKILL (External Termination)" "$BIN_DIR/unknown_signal" "EXTERNAL_TERMINATION"
 
-# Test 8: ENOMEM (Resource Exhaustion) - may not always trigger
+# Test 8: ENOMEM (Resource Exhaustion) - errno captured by the syscall tracer
 if [ -f "$BIN_DIR/enomem" ]; then
-    run_test "ENOMEM (Out of Memory)" "$BIN_DIR/enomem" "RESOURCE_EXHAUSTION"
+    run_test "ENOMEM (Out of Memory)" "$BIN_DIR/enomem" "RESOURCE_EXHAUSTION" "--trace-errno"
 fi
 
 # Test 9: Nonexistent program (exec failure)
@@ -137,6 +163,40 @@ else
 fi
 echo ""
 
+# Test 10: Pattern dictionary (-d) changes how a log is scored
+FIXTURE_DIR="$TEST_DIR/fixtures"
+run_check "Pattern Dictionary (-d)" "Failure Type: Timing/Race" \
+    -l "$FIXTURE_DIR/ecu.log" -d "$FIXTURE_DIR/patterns.dict"
+
+# Test 11: "memory" inside "out of memory" must not outscore the resource keyword
+run_check "Log Scoring (overlapping keywords)" "Failure Type: Resource Exhaustion" -l "$FIXTURE_DIR/oom.log"
+
+# Test 12-13: History store - record results, then filter and group them
+HISTORY_DIR=$(mktemp -d)
+"$ANALYZER" -H "$HISTORY_DIR" -t segv --run "$BIN_DIR/segfault" > /dev/null 2>&1 || true
+"$ANALYZER" -H "$HISTORY_DIR" -t segv --run "$BIN_DIR/segfault" > /dev/null 2>&1 || true
+"$ANALYZER" -H "$HISTORY_DIR" -t abrt --run "$BIN_DIR/abort" > /dev/null 2>&1 || true
+run_check "History Query (filter)" "Rows matched: 2" query -H "$HISTORY_DIR" -w target=segv -w signal=SIGSEGV
+run_check "History Query (group-by)" "$(printf '%-32s %s' abrt 1)" query -H "$HISTORY_DIR" -g target
+rm -rf "$HISTORY_DIR"
+
+# Test 14: Manifest mode (all of the above run concurrently)
+echo -e "${BLUE}━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━${NC}"
+echo -e "${BLUE}Test: Manifest Runner${NC}"
+echo -e "${BLUE}━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━${NC}"
+echo ""
+TOTAL=$((TOTAL + 1))
+if "$ANALYZER" --manifest "$TEST_DIR/manifest.txt" 2>&1; then
+    echo ""
+    echo -e "${GREEN}✓ Every manifest test matched its expectation${NC}"
+    PASSED=$((PASSED + 1))
+else
+    echo ""
+    echo -e "${RED}✗ Manifest run reported failures${NC}"
+    FAILED=$((FAILED + 1))
+fi
+echo ""
+
 # Summary
 echo -e "${BLUE}========================================${NC}"
 echo -e "${BLUE}Test Summary${NC}"
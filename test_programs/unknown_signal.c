@@ -1,4 +1,4 @@
-/* Test program: Raises SIGKILL (signal 9) which is not in supported signal set */
+/* Test program: Raises SIGKILL (signal 9), which has no dedicated rule */
 #define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
@@ -7,7 +7,7 @@
 
 int main(void) {
     printf("Raising SIGKILL (signal 9)...\n");
-    kill(getpid(), SIGKILL);  /* Kill signal - not in supported set */
+    kill(getpid(), SIGKILL);  /* Kill signal - classified as external termination */
     return 0;
 }
 